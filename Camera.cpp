@@ -0,0 +1,65 @@
+#include "Camera.h"
+#include <algorithm>
+#include <cmath>
+
+void Camera::fit_world(int width, int height) {
+    world_width = width;
+    world_height = height;
+    zoom = std::min(1.0f, min_zoom());
+    x = 0.0f;
+    y = 0.0f;
+    clamp();
+}
+
+float Camera::min_zoom() const {
+    return std::min(float(view_width) / world_width, float(view_height) / world_height);
+}
+
+void Camera::zoom_at(float factor, int sx, int sy) {
+    float wx, wy;
+    to_world(sx, sy, wx, wy);
+    zoom = std::clamp(zoom * factor, std::min(1.0f, min_zoom()), CAMERA_MAX_ZOOM);
+    x = wx - sx / zoom;
+    y = wy - sy / zoom;
+    clamp();
+}
+
+void Camera::pan(float screen_dx, float screen_dy) {
+    x -= screen_dx / zoom;
+    y -= screen_dy / zoom;
+    clamp();
+}
+
+void Camera::clamp() {
+    float visible_w = view_width / zoom;
+    float visible_h = view_height / zoom;
+    if (visible_w >= world_width) x = (world_width - visible_w) / 2.0f;
+    else x = std::clamp(x, 0.0f, world_width - visible_w);
+    if (visible_h >= world_height) y = (world_height - visible_h) / 2.0f;
+    else y = std::clamp(y, 0.0f, world_height - visible_h);
+}
+
+SDL_Rect Camera::to_screen(float cx, float cy, int w, int h) const {
+    // Keep tiny objects visible when zoomed far out
+    int sw = std::max(1, int(std::lround(w * zoom)));
+    int sh = std::max(1, int(std::lround(h * zoom)));
+    int sx = int(std::lround((cx - x) * zoom)) - sw / 2;
+    int sy = int(std::lround((cy - y) * zoom)) - sh / 2;
+    return {sx, sy, sw, sh};
+}
+
+void Camera::to_screen_point(float wx, float wy, int& sx, int& sy) const {
+    sx = int(std::lround((wx - x) * zoom));
+    sy = int(std::lround((wy - y) * zoom));
+}
+
+void Camera::to_world(int sx, int sy, float& wx, float& wy) const {
+    wx = x + sx / zoom;
+    wy = y + sy / zoom;
+}
+
+bool Camera::visible(float cx, float cy, int w, int h) const {
+    float hw = w / 2.0f, hh = h / 2.0f;
+    return cx + hw >= x && cx - hw <= x + view_width / zoom &&
+           cy + hh >= y && cy - hh <= y + view_height / zoom;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <SDL.h>
+#include "Settings.h"
+
+// View of the world shown in the game area of the window. The world can be larger
+// than the view; the camera maps world units to screen pixels and culls what is off-screen.
+struct Camera {
+    float x = 0.0f, y = 0.0f; // world position of the view's top-left corner
+    float zoom = 1.0f;        // screen pixels per world unit
+    int view_width = SCREEN_WIDTH;
+    int view_height = SCREEN_HEIGHT;
+    int world_width = SCREEN_WIDTH;
+    int world_height = SCREEN_HEIGHT;
+
+    // Zooms out until the whole world fits the view (never beyond 1:1)
+    void fit_world(int width, int height);
+    // Zooms by factor, keeping the world point under screen pixel (sx, sy) in place
+    void zoom_at(float factor, int sx, int sy);
+    void pan(float screen_dx, float screen_dy);
+    // Keeps the view inside the world (centred when the world is smaller than the view)
+    void clamp();
+
+    float min_zoom() const;
+    // Screen rectangle of a world-space box of size (w, h) centred at (cx, cy)
+    SDL_Rect to_screen(float cx, float cy, int w, int h) const;
+    void to_screen_point(float wx, float wy, int& sx, int& sy) const;
+    void to_world(int sx, int sy, float& wx, float& wy) const;
+    bool visible(float cx, float cy, int w, int h) const;
+};
@@ -0,0 +1,33 @@
+#include "Collisions.h"
+#include "Game.h"
+#include "Player.h"
+#include <algorithm>
+
+void CollisionSweep::resolve(Game& game) {
+    entries.clear();
+    for (auto* p : game.players) {
+        if (!p || !p->alive) continue;
+        // Player::collide's reach: 0.9 of the mean half extent
+        const float r = 0.9f * (p->width + p->height) / 4.0f;
+        entries.push_back({p->x - r, p->x + r, p->y - r, p->y + r, p->uid, p});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.min_x != b.min_x ? a.min_x < b.min_x : a.uid < b.uid;
+    });
+    pairs.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& a = entries[i];
+        for (size_t j = i + 1; j < entries.size() && entries[j].min_x < a.max_x; ++j) {
+            const Entry& b = entries[j];
+            if (b.min_y < a.max_y && a.min_y < b.max_y) pairs.push_back({a.player, b.player});
+        }
+    }
+    // eatPlayer only succeeds for the taller of the two, so at most one direction eats
+    kills = 0;
+    for (auto& [a, b] : pairs) {
+        if (!a->alive || !b->alive) continue;
+        if (a->eatPlayer(game, *b) || b->eatPlayer(game, *a)) ++kills;
+    }
+    swept = entries.size();
+    candidates = pairs.size();
+}
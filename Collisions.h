@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+class Game;
+class Player;
+
+// The player-eats-player phase, run once per tick after everything has moved. A sort and
+// sweep over x finds each overlapping pair once: the alive players (hunters included) are
+// sorted by the left edge of their collision circle, and each is paired with the ones whose
+// left edge starts before its right edge and whose y extents also overlap. The pairs are
+// then resolved in sweep order (left edge, then uid), so the outcome does not depend on the
+// order of game.players. Sizes and liveness are re-checked at resolution: an agent eaten
+// earlier in the phase eats nothing, and an eater that grew keeps its new size.
+class CollisionSweep {
+public:
+    void resolve(Game& game);
+    // In the last resolve: alive players swept, candidate pairs and pairs that ended in a kill
+    size_t swept = 0, candidates = 0, kills = 0;
+
+private:
+    struct Entry {
+        float min_x, max_x, min_y, max_y;
+        uint32_t uid;
+        Player* player;
+    };
+    std::vector<Entry> entries;
+    std::vector<std::pair<Player*, Player*>> pairs;
+};
@@ -0,0 +1,173 @@
+#include "Evaluator.h"
+#include "Game.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+extern thread_local int game_time_units;
+
+namespace {
+    // Spreads (seed, scenario) over the seed space so neighbouring scenarios are unrelated
+    unsigned int scenario_seed(unsigned int seed, int scenario) {
+        uint32_t h = seed * 0x9E3779B9u + static_cast<uint32_t>(scenario) * 0x85EBCA6Bu;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        return h;
+    }
+
+    SDL_Color random_color() {
+        return {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
+    }
+
+    std::vector<int> ranks(const std::vector<float>& values) {
+        std::vector<int> order(values.size()), rank(values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return values[a] > values[b]; });
+        for (size_t r = 0; r < order.size(); ++r) rank[order[r]] = int(r);
+        return rank;
+    }
+
+    float spearman(const std::vector<float>& a, const std::vector<float>& b) {
+        const double n = double(a.size());
+        if (a.size() < 2) return 1.0f;
+        std::vector<int> rank_a = ranks(a), rank_b = ranks(b);
+        double d2 = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) d2 += double(rank_a[i] - rank_b[i]) * (rank_a[i] - rank_b[i]);
+        return float(1.0 - 6.0 * d2 / (n * (n * n - 1.0)));
+    }
+}
+
+float run_scenario(const Player::GeneEntry& genome, const EvalConfig& config, int scenario, int* ticks,
+                   std::vector<std::array<float, NN_INPUTS>>* focal_inputs) {
+    sim_srand(scenario_seed(config.seed, scenario));
+    game_time_units = 0;
+    Game game(nullptr, config.world_width, config.world_height);
+    // The genome is spawned first, so every genome meets the same world: the draws after it
+    // (opponents, hunters, food) do not depend on its weights
+    game.newPlayer(genome.genes, genome.biases, DOT_WIDTH, DOT_HEIGHT, random_color(), SPEED);
+    Player* focal = game.players.back();
+    for (int i = 0; i < config.opponents; ++i) {
+        auto [genes, biases] = random_genes_and_biases();
+        game.newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, random_color(), SPEED);
+    }
+    if (config.hunters > 0) game.newHunter(config.hunters, HUNTER_WIDTH, HUNTER_HEIGHT, HUNTER_COLOR, SPEED, false, false);
+    game.randomFood(config.foods);
+    int tick = 0;
+    while (tick < config.ticks) {
+        game.step_world();
+        ++tick;
+        // Mitosis also ends the focal player; its children carry mutated genes
+        if (!focal->alive) break;
+        if (focal_inputs) focal_inputs->push_back(focal->smoothed_inputs);
+        game.remove_dead_players(false);
+    }
+    float fitness = Game::calc_fitness(focal);
+    game.reset();
+    if (ticks) *ticks = tick;
+    return fitness;
+}
+
+std::vector<EvalResult> evaluate_genomes(const std::vector<Player::GeneEntry>& genomes, const EvalConfig& config) {
+    std::vector<EvalResult> results(genomes.size());
+    const int scenarios = std::max(1, config.scenarios);
+    for (auto& result : results) result.fitness.assign(scenarios, 0.0f);
+    // Built once here rather than lazily by the first players of several threads
+    Player::init_lookup_tables();
+
+    const size_t jobs = genomes.size() * scenarios;
+    std::vector<int> job_ticks(jobs, 0);
+    auto run_jobs = [&](size_t begin, size_t end) {
+        for (size_t job = begin; job < end; ++job) {
+            size_t g = job / scenarios;
+            int s = int(job % scenarios);
+            results[g].fitness[s] = run_scenario(genomes[g], config, s, &job_ticks[job]);
+        }
+    };
+    // A scenario is thousands of ticks, always worth a task of its own
+    if (config.threads == 1) run_jobs(0, jobs);
+    else ThreadPool::shared().parallel_for(jobs, POOL_MIN_TASK_WORK, run_jobs);
+
+    for (size_t g = 0; g < results.size(); ++g) {
+        EvalResult& result = results[g];
+        for (int s = 0; s < scenarios; ++s) result.ticks += job_ticks[g * scenarios + s];
+        double sum = 0.0, sum_sq = 0.0;
+        for (float f : result.fitness) {
+            sum += f;
+            sum_sq += double(f) * f;
+        }
+        double mean = sum / scenarios;
+        result.mean = float(mean);
+        result.variance = float(std::max(0.0, sum_sq / scenarios - mean * mean));
+    }
+    return results;
+}
+
+std::vector<DivergenceReport> measure_inference_divergence(const std::vector<Player::GeneEntry>& genomes, const EvalConfig& config) {
+    const InferenceMode previous = g_inference_mode;
+    const InferenceMode modes[] = {InferenceMode::Float32, InferenceMode::Int8, InferenceMode::Float16};
+    Player::init_lookup_tables();
+
+    // The inputs each genome actually meets, recorded from its fp32 run of the first scenario
+    g_inference_mode = InferenceMode::Float32;
+    std::vector<std::vector<std::array<float, NN_INPUTS>>> inputs(genomes.size());
+    for (size_t g = 0; g < genomes.size(); ++g) run_scenario(genomes[g], config, 0, nullptr, &inputs[g]);
+
+    std::vector<DivergenceReport> reports;
+    std::vector<float> reference_fitness;
+    for (InferenceMode mode : modes) {
+        g_inference_mode = mode;
+        DivergenceReport report;
+        report.mode = mode;
+        double angle_sum = 0.0, speed_sum = 0.0, seconds = 0.0;
+        long long samples = 0;
+        volatile float sink = 0.0f;
+        for (size_t g = 0; g < genomes.size(); ++g) {
+            Player reference(genomes[g].genes, genomes[g].biases, DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, 0.0f, 0.0f);
+            reference.qnet = QuantizedNet();
+            Player player(genomes[g].genes, genomes[g].biases, DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, 0.0f, 0.0f);
+            report.weight_bytes = player.qnet.empty() ? NN_WEIGHT_COUNT * sizeof(float) : player.qnet.weight_bytes();
+            for (const auto& input : inputs[g]) {
+                auto expected = reference.forward(input);
+                auto actual = player.forward(input);
+                // predict() maps the angle output [-1, 1] to [0, 2pi] and the speed output [0, 1] to [0, MAX_SPEED]
+                float angle_error = std::fabs(actual[0] - expected[0]) * float(M_PI);
+                float speed_error = std::fabs(actual[1] - expected[1]) * MAX_SPEED;
+                angle_sum += angle_error;
+                speed_sum += speed_error;
+                report.max_angle_error = std::max(report.max_angle_error, angle_error);
+                report.max_speed_error = std::max(report.max_speed_error, speed_error);
+            }
+            samples += (long long)inputs[g].size();
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& input : inputs[g]) sink = sink + player.forward(input)[0];
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        if (samples > 0) {
+            report.mean_angle_error = float(angle_sum / samples);
+            report.mean_speed_error = float(speed_sum / samples);
+            report.ns_per_forward = seconds * 1e9 / samples;
+        }
+
+        std::vector<EvalResult> results = evaluate_genomes(genomes, config);
+        std::vector<float> fitness;
+        for (const auto& result : results) fitness.push_back(result.mean);
+        if (reference_fitness.empty()) reference_fitness = fitness;
+        double fitness_sum = 0.0, change_sum = 0.0;
+        for (size_t g = 0; g < fitness.size(); ++g) {
+            fitness_sum += fitness[g];
+            change_sum += std::fabs(fitness[g] - reference_fitness[g]);
+        }
+        if (!fitness.empty()) {
+            report.mean_fitness = float(fitness_sum / fitness.size());
+            report.mean_fitness_change = float(change_sum / fitness.size());
+        }
+        report.rank_correlation = spearman(reference_fitness, fitness);
+        reports.push_back(report);
+    }
+    g_inference_mode = previous;
+    return reports;
+}
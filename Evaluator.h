@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "Settings.h"
+#include "Player.h"
+#include "QuantizedNet.h"
+
+// Scores genomes away from the live simulation. Every genome plays the same fixed set of
+// seeded micro-scenarios (food layout, hunters and random opponents derived from the seed);
+// each scenario runs in its own Game on a pool thread and never touches the gene pool,
+// the hall of fame or the adaptive mutation rate. The same seed gives the same scores
+// whatever the thread count.
+struct EvalConfig {
+    int scenarios = EVAL_SCENARIOS;
+    unsigned int seed = 1;
+    int ticks = EVAL_TICKS; // per scenario, fewer if the genome dies first
+    int world_width = EVAL_WORLD_SIZE;
+    int world_height = EVAL_WORLD_SIZE;
+    int foods = EVAL_FOODS;
+    int hunters = EVAL_HUNTERS;
+    int opponents = EVAL_OPPONENTS;
+    int threads = 0; // 1 = on the calling thread; otherwise on the shared thread pool (--threads)
+};
+
+struct EvalResult {
+    float mean = 0.0f;
+    float variance = 0.0f;         // population variance over the scenarios
+    std::vector<float> fitness;    // one per scenario
+    long long ticks = 0;           // simulated over the scenarios
+};
+
+// Game::calc_fitness of the genome at the end of one scenario (its death or the tick limit)
+// focal_inputs, if given, receives the network inputs of the genome on every tick it was alive
+float run_scenario(const Player::GeneEntry& genome, const EvalConfig& config, int scenario, int* ticks = nullptr,
+                   std::vector<std::array<float, NN_INPUTS>>* focal_inputs = nullptr);
+// Results in the order of genomes
+std::vector<EvalResult> evaluate_genomes(const std::vector<Player::GeneEntry>& genomes, const EvalConfig& config);
+
+
+// How far an inference mode (see QuantizedNet.h) moves the genomes away from their fp32 behaviour
+struct DivergenceReport {
+    InferenceMode mode = InferenceMode::Float32;
+    size_t weight_bytes = 0;        // weights of one network
+    double ns_per_forward = 0.0;
+    // Network outputs on the inputs each genome saw in its first scenario in fp32
+    float mean_angle_error = 0.0f;  // radians
+    float max_angle_error = 0.0f;
+    float mean_speed_error = 0.0f;  // units per tick
+    float max_speed_error = 0.0f;
+    // Whole scenarios, where small output differences compound over the run
+    float mean_fitness = 0.0f;
+    float mean_fitness_change = 0.0f; // mean |fitness - fp32 fitness| over the genomes
+    float rank_correlation = 1.0f;    // Spearman correlation of the genome ranking with fp32
+};
+// fp32, int8 and fp16 in that order; leaves g_inference_mode as it was
+std::vector<DivergenceReport> measure_inference_divergence(const std::vector<Player::GeneEntry>& genomes, const EvalConfig& config);
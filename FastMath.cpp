@@ -0,0 +1,3 @@
+#include "FastMath.h"
+
+bool g_fast_math = FAST_MATH;
@@ -0,0 +1,89 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "Settings.h"
+
+// Polynomial approximations of the slow transcendental functions in the per-agent tick, and the
+// sim_* functions the simulation calls, which pick the approximation or the <cmath> function
+// by g_fast_math (FAST_MATH in Settings.h, --exact-math on the command line). The error
+// bounds below are checked over their whole input ranges by AI_Simulation_Bench --verify-math.
+extern bool g_fast_math;
+
+constexpr float FAST_ATAN2_MAX_ERROR = 1.2e-5f; // radians, absolute
+constexpr float FAST_EXP_MAX_REL_ERROR = 1e-6f; // relative, for x in [-80, 80]
+constexpr float FAST_TANH_MAX_ERROR = 1e-6f;    // absolute
+constexpr float FAST_SINCOS_MAX_ERROR = 1e-6f;  // absolute, for angles in [-4pi, 4pi]
+
+// Adding and subtracting 1.5 * 2^23 rounds a float of magnitude below 2^22 to the nearest
+// integer without a branch on its sign
+constexpr float FAST_ROUNDER = 12582912.0f;
+
+// atan2 from a degree-9 odd polynomial of atan on [0, 1] (Abramowitz & Stegun 4.4.49), folded
+// to the other octants. atan2(0, 0) is 0 like std::atan2; the sign of zero is not kept.
+inline float fast_atan2(float y, float x) {
+    constexpr float PI = 3.14159265358979f;
+    const float ax = std::fabs(x), ay = std::fabs(y);
+    const float hi = ax > ay ? ax : ay, lo = ax > ay ? ay : ax;
+    if (hi == 0.0f) return 0.0f;
+    const float z = lo / hi, z2 = z * z;
+    float r = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+    if (ay > ax) r = 0.5f * PI - r;
+    if (x < 0.0f) r = PI - r;
+    return y < 0.0f ? -r : r;
+}
+
+// e^x as 2^n * e^f with |f| <= ln(2)/2 and a degree-6 Taylor polynomial for e^f.
+// Inputs are clamped to [-87, 88], so the result never overflows or goes denormal. Only the
+// kernel of fast_tanh: glibc's expf is table driven and already as fast, so exp and the
+// sigmoid stay on <cmath> in both modes.
+inline float fast_exp(float x) {
+    constexpr float LOG2E = 1.44269504f;
+    constexpr float LN2_HI = 0.693145752f, LN2_LO = 1.42860677e-6f; // ln(2) split for exact n * LN2_HI
+    x = x < -87.0f ? -87.0f : (x > 88.0f ? 88.0f : x);
+    const float nf = (x * LOG2E + FAST_ROUNDER) - FAST_ROUNDER;
+    const int n = int(nf);
+    const float f = (x - nf * LN2_HI) - nf * LN2_LO;
+    const float p = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+    const uint32_t bits = uint32_t(n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// tanh(x) = 1 - 2 / (e^2x + 1); exactly +-1 beyond |x| = 9, where tanh rounds to it anyway
+inline float fast_tanh(float x) {
+    if (x > 9.0f) return 1.0f;
+    if (x < -9.0f) return -1.0f;
+    return 1.0f - 2.0f / (fast_exp(2.0f * x) + 1.0f);
+}
+
+// Both of sin and cos: reduced to [-pi/4, pi/4] by quarter turns, then degree-9 / degree-8 Taylor
+// polynomials. Meant for headings, which stay within a few turns of zero.
+inline void fast_sincos(float a, float& s, float& c) {
+    constexpr float TWO_OVER_PI = 0.636619772f;
+    constexpr float HALF_PI_HI = 1.57079601f, HALF_PI_LO = 3.13916473e-7f; // pi/2 split
+    const float qf = (a * TWO_OVER_PI + FAST_ROUNDER) - FAST_ROUNDER;
+    const int q = int(qf);
+    const float r = (a - qf * HALF_PI_HI) - qf * HALF_PI_LO;
+    const float r2 = r * r;
+    const float sr = r * (1.0f + r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f + r2 * (1.0f / 362880.0f)))));
+    const float cr = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f + r2 * (1.0f / 40320.0f))));
+    switch (q & 3) {
+        case 0: s = sr; c = cr; break;
+        case 1: s = cr; c = -sr; break;
+        case 2: s = -sr; c = -cr; break;
+        default: s = -cr; c = sr; break;
+    }
+}
+
+inline float sim_atan2(float y, float x) { return g_fast_math ? fast_atan2(y, x) : std::atan2(y, x); }
+inline float sim_tanh(float x) { return g_fast_math ? fast_tanh(x) : std::tanh(x); }
+inline void sim_sincos(float a, float& s, float& c) {
+    if (g_fast_math) {
+        fast_sincos(a, s, c);
+    } else {
+        s = std::sin(a);
+        c = std::cos(a);
+    }
+}
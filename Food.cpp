@@ -1,15 +1,22 @@
 #include "Food.h"
 #include "Game.h"
+#include <atomic>
 
 Food::Food(float x_, float y_, int width_, int height_)
     : x(x_), y(y_), width(width_), height(height_) {}
 
-void Food::update(Game& game) {
-    // Food does not update itself in this version
+namespace {
+    std::atomic<uint32_t> food_uids{0};
+}
+
+uint32_t Food::next_uid() {
+    return food_uids.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
-void Food::draw(SDL_Renderer* renderer) {
-    SDL_Rect rect = {static_cast<int>(x - width / 2.0f), static_cast<int>(y - height / 2.0f), width, height};
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); // Green
-    SDL_RenderFillRect(renderer, &rect);
+void Food::reset_uids() {
+    food_uids.store(0, std::memory_order_relaxed);
+}
+
+void Food::update(Game& game) {
+    // Food does not update itself in this version
 } 
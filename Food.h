@@ -1,13 +1,17 @@
 #pragma once
 #include "Settings.h"
 #include <SDL.h>
+#include <cstdint>
 class Game;
 
 class Food {
 public:
     Food(float x, float y, int width = FOOD_WIDTH, int height = FOOD_HEIGHT);
     void update(Game& game);
-    void draw(SDL_Renderer* renderer);
+    static uint32_t next_uid();
+    // Restarts the uids at 1, for runs that must match a previous one; live foods keep theirs
+    static void reset_uids();
+    const uint32_t uid = next_uid(); // never reused, identifies the food in replays
     float x, y;
     int width, height;
 }; 
\ No newline at end of file
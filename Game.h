@@ -3,24 +3,72 @@
 #include "Settings.h"
 #include <SDL.h>
 #include <array>
+#include <functional>
+#include "SpatialGrid.h"
+#include "Sensing.h"
+#include "Collisions.h"
+#include "Offspring.h"
+#include "Population.h"
+#include "Novelty.h"
+#include <atomic>
+#include <cstdint>
 class Player;
 class Food;
 class Hunter;
 
+// Level-of-detail update scheduling (LOD_SCHEDULING). Counts bot updates at each rate: a
+// bot is at the reduced rate while isolated, whether or not its network runs this tick.
+struct LodScheduler {
+    int interval = LOD_SCHEDULING ? LOD_INTERVAL : 1; // ticks between network runs when isolated; 1 = off
+    float radius = LOD_RADIUS;
+    long long full = 0, reduced = 0; // since construction
+    bool enabled() const { return interval > 1; }
+    // Share of the bot updates counted since the given totals that ran at the reduced rate
+    float reduced_fraction(long long since_full = 0, long long since_reduced = 0) const {
+        long long f = full - since_full, r = reduced - since_reduced;
+        return f + r > 0 ? float(r) / float(f + r) : 0.0f;
+    }
+};
+
 class Game {
 public:
-    Game(SDL_Renderer* renderer);
+    Game(SDL_Renderer* renderer, int world_width = SCREEN_WIDTH, int world_height = SCREEN_HEIGHT);
+    // Resizes the world (and its grids); call on an empty game, e.g. right after reset()
+    void set_world_size(int world_width, int world_height);
+    // One tick: step_world() then maintain_population()
     void update();
-    void render();
+    // Moves players, hunters and food one tick without touching the gene pool or population
+    void step_world();
     void handleEvents();
     void reset();
+    // Appends a spawned player (bot, human or hunter) and counts it in population
+    void add_player(Player* p);
+    // Marks p dead and uncounts it; every death goes through here
+    void kill_player(Player& p);
+    // p's food count changed (eating, hunger): keeps top_bots current
+    void food_changed(Player& p);
+    // Recounts from scratch, for code that sets Player::alive directly (benchmarks)
+    void recount_population();
+    PopulationCounts population;
+    TopBots top_bots;
     void newPlayer(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, int width = DOT_WIDTH, int height = DOT_HEIGHT, SDL_Color color = DOT_COLOR, float speed = SPEED);
     void newHunter(int number = 1, int width = HUNTER_WIDTH, int height = HUNTER_HEIGHT, SDL_Color color = HUNTER_COLOR, float speed = SPEED, bool random_color = true, bool random_size = false);
     void randomFood(int num = 1);
     void maintain_population();
+    // State maintain_population keeps between calls; reset() clears it
+    int generation = 0;
+    float best_fitness = 0.0f; // best alive fitness seen, for the adaptive mutation rate
+    int generations_since_improvement = 0;
+    std::vector<Player*> sorted_alive;
+    std::vector<OffspringBatch::Elite> elite_genomes; // kept until the next check, by value
+    // Deletes dead non-hunter players; keep_genes offers fit bots to the gene pool first
+    void remove_dead_players(bool keep_genes);
+    static float calc_fitness(const Player* p);
 
-    int width = SCREEN_WIDTH;
+    int width = SCREEN_WIDTH;  // world size, independent of the window
     int height = SCREEN_HEIGHT;
+    // World point the human player steers towards; written by the UI thread
+    std::atomic<float> pointer_x{0.0f}, pointer_y{0.0f};
     std::vector<Player*> players;
     std::vector<Hunter*> hunters;
     std::vector<Food*> foods;
@@ -29,12 +77,41 @@ public:
     // Add more as needed
 
     // --- Spatial Partitioning ---
+    // Grids are rebuilt at the start of every tick. Anything spawned later in the tick is
+    // tracked separately (players past players_in_grid, foods_since_grid) so the nearest
+    // queries stay exact; eaten food is unlinked through remove_food.
     static constexpr int CELL_SIZE = GRID_CELL_SIZE;
-    static constexpr int GRID_WIDTH = (SCREEN_WIDTH + CELL_SIZE - 1) / CELL_SIZE;
-    static constexpr int GRID_HEIGHT = (SCREEN_HEIGHT + CELL_SIZE - 1) / CELL_SIZE;
-    std::vector<Player*> player_grid[GRID_WIDTH][GRID_HEIGHT];
-    std::vector<Food*> food_grid[GRID_WIDTH][GRID_HEIGHT];
+    SpatialGrid<Player> player_grid; // alive players (bots, humans and hunters)
+    SpatialGrid<Food> food_grid;
+    size_t players_in_grid = 0;
+    std::vector<Food*> foods_since_grid;
     void update_grids();
+    SensorBatch sensors; // this tick's batched sensing (BATCHED_SENSING)
+    LodScheduler lod;
+    CollisionSweep collisions; // player-eats-player, once per tick after hunters move
+    OffspringBatch offspring;  // the population refill of maintain_population
+    NoveltySearch novelty;     // behaviour archive and novelty scores (FITNESS_WEIGHT_NOVELTY)
     std::vector<Player*> get_nearby_players(float x, float y);
     std::vector<Food*> get_nearby_food(float x, float y);
+    // Nearest food by centre distance (nullptr if there is none). runner_up, if given, gets a
+    // lower bound on the distance of every other food (see SpatialGrid::nearest).
+    Food* nearest_food(float x, float y, float& dist, float* runner_up = nullptr) const;
+    // Nearest other alive player by edge distance (centre distance minus both radii)
+    Player* nearest_player(const Player& self, float& edge_dist, float* runner_up = nullptr) const;
+    // The metrics of the two queries above
+    static float food_distance(float x, float y, const Food& food);
+    static float edge_distance(const Player& self, const Player& other);
+    // Food spawned and removed since the last sensing pass, for the lazy sensing caches
+    struct FoodEvent {
+        uint32_t uid;
+        float x, y;
+        bool spawned; // false: eaten
+    };
+    std::vector<FoodEvent> food_events;
+    // Nearest player accepted by the filter, by centre distance
+    Player* nearest_player_if(float x, float y, const std::function<bool(const Player*)>& accept, float& dist) const;
+    // Deletes an eaten food and unlinks it from foods and the grid
+    void remove_food(Food* food);
+    // True if a square of the given width at (x, y) would overlap a player or food
+    bool spawn_blocked(float x, float y, int width);
 }; 
\ No newline at end of file
@@ -14,9 +14,12 @@
 #include <vector>
 #include "Game.h"
 #include "Settings.h"
+#include "Random.h"
+#include "Tunables.h"
+#include "Profiler.h"
+#include "Snapshot.h"
 #include <cmath>
-
-extern int game_time_units;
+#include <chrono>
 
 GameApp::GameApp() {}
 GameApp::~GameApp() {}
@@ -62,6 +65,7 @@ bool GameApp::init() {
     print_section("[Fitness]");
     print_kv("TOP_ALIVE_TO_INSERT", TOP_ALIVE_TO_INSERT);
     print_kv("FITNESS_WEIGHT_FOOD", FITNESS_WEIGHT_FOOD); print_kv("FITNESS_WEIGHT_LIFE", FITNESS_WEIGHT_LIFE); print_kv("FITNESS_WEIGHT_EXPLORE", FITNESS_WEIGHT_EXPLORE); print_kv("FITNESS_WEIGHT_PLAYERS", FITNESS_WEIGHT_PLAYERS);
+    print_kv("FITNESS_WEIGHT_NOVELTY", FITNESS_WEIGHT_NOVELTY);
     print_kv("FITNESS_MIN_FOOD", FITNESS_MIN_FOOD); print_kv("FITNESS_MIN_LIFE", FITNESS_MIN_LIFE); print_kv("FITNESS_EARLY_DEATH_TIME", FITNESS_EARLY_DEATH_TIME); print_kv("FITNESS_EARLY_DEATH_PENALTY", FITNESS_EARLY_DEATH_PENALTY);
     print_kv("FITNESS_MIN_FOR_REPRO", FITNESS_MIN_FOR_REPRO); print_kv("FITNESS_MIN_LIFETIME_FOR_REPRO", FITNESS_MIN_LIFETIME_FOR_REPRO);
     print_kv("FITNESS_DIVERSITY_PRUNE_MIN_DIST", FITNESS_DIVERSITY_PRUNE_MIN_DIST); print_kv("MIN_FITNESS_FOR_GENE_POOL", MIN_FITNESS_FOR_GENE_POOL);
@@ -110,88 +114,132 @@ bool GameApp::init() {
     speed_steps = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, -1, -2};
     speed_index = 0;
     sim_speed = speed_steps[speed_index];
-    logic_max_mode = false;
     show_menu = true;
     show_settings = false;
     sim_start_time = SDL_GetTicks();
-    last_gene_pool_save = SDL_GetTicks();
+    if (!replay_path.empty()) {
+        // Playback only: no game, no gene pool
+        replay = new ReplayPlayer();
+        if (!replay->load(replay_path)) {
+            cleanup();
+            return false;
+        }
+        camera.fit_world(replay->world_width(), replay->world_height());
+        replay_cursor = double(replay->first_tick());
+        replay->fill_snapshot(replay_snapshot);
+        return true;
+    }
     // Load gene pool
     Player::load_gene_pool("gene_pool.txt");
-    // Create game
-    game = new Game(renderer);
-    restart_simulation();
+    // Create game; from run() on it belongs to the simulation thread
+    game = new Game(renderer, world_width, world_height);
+    camera.fit_world(game->width, game->height);
+    restart_simulation(current_settings());
+    sim = new SimThread(*game, [this](const SimSettings& settings) { restart_simulation(settings); });
     return true;
 }
 
 void GameApp::cleanup() {
-    Player::save_gene_pool("gene_pool.txt");
+    if (sim) sim->stop();
+    delete sim;
+    sim = nullptr;
+    if (game) Player::save_gene_pool("gene_pool.txt"); // a replay session never loaded it
+    delete replay;
+    replay = nullptr;
+    text_cache.clear();
     if (font) TTF_CloseFont(font);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
     TTF_Quit();
     SDL_Quit();
     if (game) delete game;
+    game = nullptr;
+    font = nullptr;
+    renderer = nullptr;
+    window = nullptr;
 }
 
 // Helper to render text
 void GameApp::renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect dst = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, NULL, &dst);
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    text_cache.draw(renderer, font, text, x, y, color);
 }
 
-void GameApp::restart_simulation(const std::vector<std::vector<std::vector<float>>>* loaded_genes, const std::vector<std::vector<float>>* best_gene) {
-    for (auto* p : game->players) delete p;
-    for (auto* f : game->foods) delete f;
-    game->players.clear();
-    game->hunters.clear();
-    game->foods.clear();
-    g_bot_count = std::max(g_bot_count, MIN_BOT);
-    int bots_to_spawn = g_bot_count;
-    if (g_player_enabled) {
-        game->players.push_back(new HumanPlayer(DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, SCREEN_WIDTH/2, SCREEN_HEIGHT/2));
+void GameApp::set_world_size(int width, int height) {
+    world_width = width;
+    world_height = height;
+}
+
+void GameApp::set_replay(const std::string& path) {
+    replay_path = path;
+}
+
+void GameApp::seek_replay(double tick) {
+    replay_cursor = std::clamp(tick, double(replay->first_tick()), double(replay->last_tick()));
+    replay->seek_tick((long long)replay_cursor);
+}
+
+void GameApp::advance_replay(double seconds) {
+    double span = double(replay->last_tick() - replay->first_tick());
+    double rate = sim_speed > 0 ? double(sim_speed) * SIM_BASE_TPS : span / REPLAY_MAX_SECONDS;
+    seek_replay(replay_cursor + rate * seconds);
+    if (replay_cursor >= double(replay->last_tick())) paused = true; // stop at the end
+}
+
+SimSettings GameApp::current_settings() const {
+    SimSettings settings;
+    settings.bot_count = std::max(g_bot_count, MIN_BOT);
+    settings.food_count = g_food_count;
+    settings.hunters_enabled = g_hunters_enabled;
+    settings.hunter_count = g_hunter_count;
+    settings.player_enabled = g_player_enabled;
+    return settings;
+}
+
+void GameApp::restart_simulation(const SimSettings& settings) {
+    game->reset();
+    int bots_to_spawn = settings.bot_count;
+    if (settings.player_enabled) {
+        game->add_player(new HumanPlayer(DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, game->width/2, game->height/2));
         bots_to_spawn -= 1;
     }
-    if (loaded_genes && !loaded_genes->empty()) {
-        int used = 0;
-        for (const auto& genes : *loaded_genes) {
-            if (bots_to_spawn <= 0) break;
-            SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
-            game->players.push_back(new Player(genes, std::vector<std::vector<float>>(genes.size()), DOT_WIDTH, DOT_HEIGHT, color, static_cast<float>(rand() % SCREEN_WIDTH), static_cast<float>(rand() % SCREEN_HEIGHT)));
-            used++;
-            bots_to_spawn--;
-        }
-        if (used < bots_to_spawn) {
-            for (int i = 0; i < bots_to_spawn - used; ++i) {
-                auto [genes, biases] = random_genes_and_biases();
-                SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
-                game->newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
-            }
-        }
-    } else if (best_gene && !best_gene->empty()) {
-        for (int i = 0; i < bots_to_spawn; ++i) {
-            SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
-            game->players.push_back(new Player(*best_gene, std::vector<std::vector<float>>(best_gene->size()), DOT_WIDTH, DOT_HEIGHT, color, static_cast<float>(rand() % SCREEN_WIDTH), static_cast<float>(rand() % SCREEN_HEIGHT)));
-        }
-    } else {
-        for (int i = 0; i < bots_to_spawn; ++i) {
-            auto [genes, biases] = random_genes_and_biases();
-            SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
-            game->newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
-        }
+    for (int i = 0; i < bots_to_spawn; ++i) {
+        auto [genes, biases] = random_genes_and_biases();
+        SDL_Color color = {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
+        game->newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
     }
-    if (g_hunters_enabled) {
-        game->newHunter(g_hunter_count, HUNTER_WIDTH, HUNTER_HEIGHT, HUNTER_COLOR, SPEED, false, false);
+    if (settings.hunters_enabled) {
+        game->newHunter(settings.hunter_count, HUNTER_WIDTH, HUNTER_HEIGHT, HUNTER_COLOR, SPEED, false, false);
     }
-    game->randomFood(g_food_count);
+    game->randomFood(settings.food_count);
     // Reset mutation rate and update display after restart
-    Player::adaptive_mutation_rate = MUTATION_RATE;
+    Player::adaptive_mutation_rate = g_tunables.mutation_rate;
     Player::set_display_mutation_rate(Player::adaptive_mutation_rate);
 }
 
+void GameApp::request_restart() {
+    if (replay) {
+        seek_replay(double(replay->first_tick()));
+        return;
+    }
+    g_bot_count = std::max(g_bot_count, MIN_BOT);
+    SimCommand command{SimCommand::Type::Restart};
+    command.settings = current_settings();
+    sim->post(command);
+}
+
+void GameApp::set_paused(bool value) {
+    paused = value;
+    if (sim) sim->post({value ? SimCommand::Type::Pause : SimCommand::Type::Resume});
+}
+
+void GameApp::set_speed_index(int index) {
+    speed_index = std::clamp(index, 0, (int)speed_steps.size() - 1);
+    sim_speed = speed_steps[speed_index];
+    SimCommand command{SimCommand::Type::SetSpeed};
+    command.speed = sim_speed;
+    if (sim) sim->post(command);
+}
+
 // --- Mouse interaction state for settings ---
 struct SettingSlider {
     std::string label;
@@ -215,12 +263,51 @@ void GameApp::run() {
     quit = false;
     paused = true;
     sim_start_time = SDL_GetTicks();
-    last_gene_pool_save = SDL_GetTicks();
+    if (sim) sim->start(paused, sim_speed);
+    Uint32 last_frame_start = SDL_GetTicks();
     while (!quit) {
+        Uint32 frame_start = SDL_GetTicks();
         while (SDL_PollEvent(&e) != 0) {
             if (e.type == SDL_QUIT) {
                 quit = true;
             }
+            // Camera: mouse wheel zooms at the cursor, right-drag pans
+            if (e.type == SDL_MOUSEWHEEL) {
+                int mx, my;
+                SDL_GetMouseState(&mx, &my);
+                if (mx < SCREEN_WIDTH) camera.zoom_at(e.wheel.y > 0 ? CAMERA_ZOOM_STEP : 1.0f / CAMERA_ZOOM_STEP, mx, my);
+            }
+            if (e.type == SDL_MOUSEMOTION && (e.motion.state & SDL_BUTTON_RMASK)) {
+                camera.pan(float(e.motion.xrel), float(e.motion.yrel));
+            }
+            // Replay: LEFT/RIGHT scrub, HOME/END jump, the sidebar bar seeks
+            if (replay) {
+                double span = double(replay->last_tick() - replay->first_tick());
+                if (e.type == SDL_KEYDOWN) {
+                    switch (e.key.keysym.sym) {
+                        case SDLK_LEFT: seek_replay(replay_cursor - span * REPLAY_SCRUB_FRACTION); break;
+                        case SDLK_RIGHT: seek_replay(replay_cursor + span * REPLAY_SCRUB_FRACTION); break;
+                        case SDLK_HOME: seek_replay(double(replay->first_tick())); break;
+                        case SDLK_END: seek_replay(double(replay->last_tick())); break;
+                    }
+                }
+                int bar_x = -1;
+                if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT &&
+                    e.button.x >= replay_bar.x && e.button.x <= replay_bar.x + replay_bar.w &&
+                    e.button.y >= replay_bar.y - 4 && e.button.y <= replay_bar.y + replay_bar.h + 4) {
+                    dragging_replay_bar = true;
+                    bar_x = e.button.x;
+                }
+                if (e.type == SDL_MOUSEMOTION && dragging_replay_bar) bar_x = e.motion.x;
+                if (e.type == SDL_MOUSEBUTTONUP && e.button.button == SDL_BUTTON_LEFT) dragging_replay_bar = false;
+                if (bar_x >= 0 && replay_bar.w > 0) {
+                    double t = std::clamp(double(bar_x - replay_bar.x) / replay_bar.w, 0.0, 1.0);
+                    seek_replay(double(replay->first_tick()) + t * span);
+                }
+            }
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_c) {
+                camera.fit_world(camera.world_width, camera.world_height);
+            }
             if (e.type == SDL_KEYDOWN) {
                 if (paused) {
                     // check keys for paused state - settings
@@ -262,38 +349,35 @@ void GameApp::run() {
                                 g_hunters_enabled = pending_hunters_enabled;
                                 g_hunter_count = pending_hunter_count;
                                 g_player_enabled = pending_player_enabled;
-                                restart_simulation();
+                                request_restart();
                             }
-                            paused = false;
+                            set_paused(false);
                             break;
                         }
                         case SDLK_r:
-                            restart_simulation();
+                            request_restart();
+                            break;
+                        case SDLK_t:
+                            show_profiler = !show_profiler;
                             break;
                         case SDLK_UP:
-                            speed_index = std::min((int)speed_steps.size() - 1, speed_index + 1);
-                            sim_speed = speed_steps[speed_index];
-                            logic_max_mode = (sim_speed == -2);
+                            set_speed_index(speed_index + 1);
                             break;
                         case SDLK_DOWN:
-                            speed_index = std::max(0, speed_index - 1);
-                            sim_speed = speed_steps[speed_index];
-                            logic_max_mode = false;
+                            set_speed_index(speed_index - 1);
                             break;
                     }
                 } else {
                     if (e.key.keysym.sym == SDLK_ESCAPE) {
-                        paused = true;
+                        set_paused(true);
                     } else if (e.key.keysym.sym == SDLK_r) {
-                        restart_simulation();
+                        request_restart();
+                    } else if (e.key.keysym.sym == SDLK_t) {
+                        show_profiler = !show_profiler;
                     } else if (e.key.keysym.sym == SDLK_UP) {
-                        speed_index = std::min((int)speed_steps.size() - 1, speed_index + 1);
-                        sim_speed = speed_steps[speed_index];
-                        logic_max_mode = (sim_speed == -2);
+                        set_speed_index(speed_index + 1);
                     } else if (e.key.keysym.sym == SDLK_DOWN) {
-                        speed_index = std::max(0, speed_index - 1);
-                        sim_speed = speed_steps[speed_index];
-                        logic_max_mode = false;
+                        set_speed_index(speed_index - 1);
                     }
                 }
             }
@@ -309,119 +393,44 @@ void GameApp::run() {
             }
             if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT && hovered_button != -1) {
                 std::string action = sidebar_buttons[hovered_button].action;
-                if (action == "pause") { paused = !paused; }
+                if (action == "pause") { set_paused(!paused); }
                 else if (action == "settings") {
-                    paused = true;
+                    set_paused(true);
                     pending_bot_count = g_bot_count;
                     pending_food_count = g_food_count;
                     pending_hunters_enabled = g_hunters_enabled;
                     pending_hunter_count = g_hunter_count;
                     pending_player_enabled = g_player_enabled;
                 }
-                else if (action == "restart") restart_simulation();
-                else if (action == "speed_up") {
-                    speed_index = std::min((int)speed_steps.size() - 1, speed_index + 1);
-                    sim_speed = speed_steps[speed_index];
-                    logic_max_mode = (sim_speed == -2);
-                }
-                else if (action == "speed_down") {
-                    speed_index = std::max(0, speed_index - 1);
-                    sim_speed = speed_steps[speed_index];
-                    logic_max_mode = false;
-                }
-            }
-        }
-        if (sim_speed == -2) {
-            // LOGIC MAX: render sidebar with LOGIC MAX and timer before freezing
-            SDL_SetRenderDrawColor(renderer, 10, 10, 10, 255);
-            SDL_RenderClear(renderer);
-            SDL_Rect game_area = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-            SDL_SetRenderDrawColor(renderer, 18, 18, 18, 255);
-            SDL_RenderFillRect(renderer, &game_area);
-            game->render();
-            SDL_Rect sidebar = {SCREEN_WIDTH, 0, 200, SCREEN_HEIGHT};
-            SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255);
-            SDL_RenderFillRect(renderer, &sidebar);
-            SDL_Color white = {255,255,255,255};
-            SDL_Color green = {0,255,0,255};
-            SDL_Color yellow = {255,255,0,255};
-            SDL_Color cyan = {0,255,255,255};
-            int y = 20;
-            int alive_players = 0, total_food = game->foods.size(), total_hunters = game->hunters.size();
-            int best_bot_id = -1;
-            int best_bot_lifetime = 0;
-            int player_index = 0;
-            for (auto* p : game->players) {
-                if (p->alive) {
-                    ++alive_players;
-                    best_bot_id = player_index;
-                    best_bot_lifetime = p->lifeTime;
-                }
-                player_index++;
-            }
-            int sidebar_x = SCREEN_WIDTH + 20;
-            renderText(renderer, font, "     --- STATS ---", sidebar_x, y, green); y += 35;
-            renderText(renderer, font, "Bots Alive: " + std::to_string(alive_players) + " / " + std::to_string(g_bot_count), sidebar_x, y, white); y += 28;
-            renderText(renderer, font, "Hunters:   " + std::string(g_hunters_enabled ? "[X] " : "[ ] ") + std::to_string(total_hunters) + " / " + std::to_string(g_hunter_count), sidebar_x, y, white); y += 28;
-            renderText(renderer, font, "Food:      " + std::to_string(total_food) + " / " + std::to_string(g_food_count), sidebar_x, y, white); y += 28;
-            Uint32 elapsed_ms = SDL_GetTicks() - sim_start_time;
-            int seconds = elapsed_ms / 1000;
-            int minutes = seconds / 60;
-            seconds = seconds % 60;
-            char timer_buf[32];
-            snprintf(timer_buf, sizeof(timer_buf), "Time: %02d:%02d", minutes, seconds);
-            renderText(renderer, font, timer_buf, sidebar_x, y, white); y += 28;
-            renderText(renderer, font, "Speed: LOGIC MAX", sidebar_x, y, white); y += 28;
-            renderText(renderer, font, "game time: " + std::to_string(game_time_units/1000) + "(k)", sidebar_x, y, white); y += 28;
-            SDL_RenderPresent(renderer);
-            logic_max_mode = true;
-            SDL_Event logic_event;
-            while (logic_max_mode && !quit) {
-                game->update();
-                while (SDL_PollEvent(&logic_event)) {
-                    if (logic_event.type == SDL_QUIT) quit = true;
-                    if (logic_event.type == SDL_KEYDOWN) {
-                        if (logic_event.key.keysym.sym == SDLK_DOWN) {
-                            speed_index = std::max(0, speed_index - 1);
-                            sim_speed = speed_steps[speed_index];
-                            logic_max_mode = false;
-                        } else if (logic_event.key.keysym.sym == SDLK_ESCAPE) {
-                            paused = !paused;
-                            logic_max_mode = false;
-                        } else if (logic_event.key.keysym.sym == SDLK_q) {
-                            quit = true;
-                        }
-                    }
-                }
+                else if (action == "restart") request_restart();
+                else if (action == "speed_up") set_speed_index(speed_index + 1);
+                else if (action == "speed_down") set_speed_index(speed_index - 1);
             }
-            continue;
         }
-        if (!paused) {
-            if (sim_speed == -1) {
-                // MAX - do as much as updates while keeping the rendering up
-                Uint32 start = SDL_GetTicks();
-                int updates = 0;
-                while (SDL_GetTicks() - start < 10) {
-                    game->update();
-                    ++updates;
-                }
-            } else {
-                // <sim_speed>X - do sim_speed updates before rendering 
-                for (int i = 0; i < sim_speed; ++i) {
-                    game->update();
-                }
-            }
+        // The human player steers towards the mouse (in world units)
+        if (game) {
+            int mx, my;
+            SDL_GetMouseState(&mx, &my);
+            float wx, wy;
+            camera.to_world(mx, my, wx, wy);
+            game->pointer_x.store(wx, std::memory_order_relaxed);
+            game->pointer_y.store(wy, std::memory_order_relaxed);
         }
-        if (SDL_GetTicks() - last_gene_pool_save > GENE_POOL_SAVE_INTERVAL) {
-            Player::save_gene_pool("gene_pool.txt");
-            last_gene_pool_save = SDL_GetTicks();
+        if (replay) {
+            if (!paused) advance_replay((frame_start - last_frame_start) / 1000.0);
+            replay->fill_snapshot(replay_snapshot);
+        } else {
+            sim->acquire();
         }
+        last_frame_start = frame_start;
+        const RenderSnapshot& snap = replay ? replay_snapshot : sim->snapshot();
         SDL_SetRenderDrawColor(renderer, 10, 10, 10, 255);
         SDL_RenderClear(renderer);
         SDL_Rect game_area = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
         SDL_SetRenderDrawColor(renderer, 18, 18, 18, 255);
         SDL_RenderFillRect(renderer, &game_area);
-        game->render();
+        draw_snapshot(snap, camera, render_batch, snap.interpolation_alpha(std::chrono::steady_clock::now()));
+        render_batch.flush(renderer);
         SDL_Rect sidebar = {SCREEN_WIDTH, 0, 200, SCREEN_HEIGHT};
         SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255);
         SDL_RenderFillRect(renderer, &sidebar);
@@ -430,14 +439,7 @@ void GameApp::run() {
         SDL_Color yellow = {255,255,0,255};
         SDL_Color cyan = {0,255,255,255};
         int y = 20;
-        int alive_players = 0, total_food = game->foods.size(), total_hunters = game->hunters.size();
-        int player_index = 0;
-        for (auto* p : game->players) {
-            if (p->alive) {
-                ++alive_players;
-            }
-            player_index++;
-        }
+        int alive_players = snap.alive_players, total_food = snap.total_food, total_hunters = snap.total_hunters;
         int sidebar_x = SCREEN_WIDTH + 20;
         auto setup_sidebar_buttons = [&](int sidebar_x, int y_start) {
             sidebar_buttons.clear();
@@ -455,7 +457,7 @@ void GameApp::run() {
         for (size_t i = 0; i < sidebar_buttons.size(); ++i) {
             SDL_Rect btn = sidebar_buttons[i].rect;
             if (sidebar_buttons[i].action == "speed_display") {
-                std::string speed_str = (sim_speed == -2) ? "LOGIC" : (sim_speed == -1) ? "MAX" : (std::to_string(sim_speed) + "x");
+                std::string speed_str = (sim_speed == SIM_SPEED_LOGIC_MAX) ? "LOGIC" : (sim_speed == SIM_SPEED_MAX) ? "MAX" : (std::to_string(sim_speed) + "x");
                 SDL_SetRenderDrawColor(renderer, 30, 30, 50, 255);
                 SDL_RenderFillRect(renderer, &btn);
                 SDL_SetRenderDrawColor(renderer, 200, 200, 220, 255);
@@ -486,59 +488,75 @@ void GameApp::run() {
         char timer_buf[32];
         snprintf(timer_buf, sizeof(timer_buf), "Time: %02d:%02d", minutes, seconds);
         renderText(renderer, font, timer_buf, sidebar_x, y, white); y += 22;
-        renderText(renderer, font, "game time: " + std::to_string(game_time_units/1000) + "(k)", sidebar_x, y, white); y += 22;
-        std::string speed_str = (sim_speed == -2) ? "LOGIC MAX" : (sim_speed == -1) ? "MAX" : (std::to_string(sim_speed) + "x");
+        renderText(renderer, font, "game time: " + std::to_string(snap.game_time_units/1000) + "(k)", sidebar_x, y, white); y += 22;
+        std::string speed_str = (sim_speed == SIM_SPEED_LOGIC_MAX) ? "LOGIC MAX" : (sim_speed == SIM_SPEED_MAX) ? "MAX" : (std::to_string(sim_speed) + "x");
         renderText(renderer, font, "Speed: " + speed_str, sidebar_x, y, white); y += 22;
+        if (!replay) {
+            std::string target_str = snap.target_tps > 0.0 ? std::to_string(int(snap.target_tps + 0.5)) : "max";
+            renderText(renderer, font, "ticks/s: " + std::to_string(int(snap.ticks_per_second + 0.5)) + " / " + target_str, sidebar_x, y, white); y += 22;
+        }
         // Show top bots and human player stats after main stats, before fitness/diversity/mutation info
         y += 8;
-        std::vector<std::pair<Player*, int>> bot_stats; // (player, index)
-        Player* human_player = nullptr;
-        int idx = 0;
-        for (auto* p : game->players) {
-            if (p->alive) {
-                if (p->is_human) {
-                    human_player = p;
-                } else {
-                    bot_stats.emplace_back(p, idx);
+        if (replay) {
+            renderText(renderer, font, "REPLAY", sidebar_x, y, yellow); y += 18;
+            renderText(renderer, font, "frame " + std::to_string(replay->frame() + 1) + " / " + std::to_string(replay->frame_count()), sidebar_x, y, white); y += 15;
+            renderText(renderer, font, "tick " + std::to_string(replay->tick()), sidebar_x, y, white); y += 18;
+            replay_bar = {sidebar_x, y, 160, 10};
+            SDL_SetRenderDrawColor(renderer, 80, 80, 120, 255);
+            SDL_RenderFillRect(renderer, &replay_bar);
+            long long span = std::max(1LL, replay->last_tick() - replay->first_tick());
+            SDL_Rect done = replay_bar;
+            done.w = int(replay_bar.w * double(replay->tick() - replay->first_tick()) / double(span));
+            SDL_SetRenderDrawColor(renderer, 120, 180, 255, 255);
+            SDL_RenderFillRect(renderer, &done);
+            y += 16;
+            renderText(renderer, font, "LEFT/RIGHT: scrub", sidebar_x, y, cyan); y += 15;
+        } else if (show_profiler) {
+            renderText(renderer, font, "PROFILER (us/tick)", sidebar_x, y, yellow); y += 18;
+            if (!TickProfiler::enabled()) {
+                renderText(renderer, font, "disabled at build time", sidebar_x, y, white); y += 15;
+            } else {
+                renderText(renderer, font, "phase          p50    p99", sidebar_x, y, cyan); y += 16;
+                for (int i = 0; i < TickProfiler::PHASES; ++i) {
+                    ProfilePhase phase = static_cast<ProfilePhase>(i);
+                    char line[64];
+                    snprintf(line, sizeof(line), "%-12s %6.0f %6.0f", TickProfiler::phase_name(phase),
+                             snap.phase_p50_us[i], snap.phase_p99_us[i]);
+                    renderText(renderer, font, line, sidebar_x, y, white); y += 15;
                 }
             }
-            ++idx;
-        }
-        // Sort bots by foodCount descending
-        std::sort(bot_stats.begin(), bot_stats.end(), [](const auto& a, const auto& b) {
-            return a.first->foodCount > b.first->foodCount;
-        });
-        renderText(renderer, font, "Top Bots:", sidebar_x, y, yellow); y += 18;
-        renderText(renderer, font, "  S    F   L(k)", sidebar_x + 24, y, cyan); y += 16;
-        for (int i = 0; i < std::min(5, (int)bot_stats.size()); ++i) {
-            y += 10;
-            Player* bot = bot_stats[i].first;
-            SDL_Rect color_rect = {sidebar_x, y, 14, 14};
-            SDL_SetRenderDrawColor(renderer, bot->color.r, bot->color.g, bot->color.b, 255);
-            SDL_RenderFillRect(renderer, &color_rect); y -= 4; // for a better look
-            std::ostringstream oss;
-            oss << std::setw(4) << std::setfill(' ') << bot->width << " "
-                << std::setw(3) << std::setfill(' ') << bot->foodCount << " "
-                << std::setw(4) << std::fixed << std::setprecision(1) << (bot->lifeTime / 1000.0f);
-            renderText(renderer, font, oss.str(), sidebar_x + 24, y, white); y += 15;
+        } else {
+            renderText(renderer, font, "Top Bots:", sidebar_x, y, yellow); y += 18;
+            renderText(renderer, font, "  S    F   L(k)", sidebar_x + 24, y, cyan); y += 16;
+            for (const auto& bot : snap.top_bots) {
+                y += 10;
+                SDL_Rect color_rect = {sidebar_x, y, 14, 14};
+                SDL_SetRenderDrawColor(renderer, bot.color.r, bot.color.g, bot.color.b, 255);
+                SDL_RenderFillRect(renderer, &color_rect); y -= 4; // for a better look
+                std::ostringstream oss;
+                oss << std::setw(4) << std::setfill(' ') << bot.width << " "
+                    << std::setw(3) << std::setfill(' ') << bot.food_count << " "
+                    << std::setw(4) << std::fixed << std::setprecision(1) << (bot.life_time / 1000.0f);
+                renderText(renderer, font, oss.str(), sidebar_x + 24, y, white); y += 15;
+            }
         }
-        if (g_player_enabled && human_player) {
+        if (g_player_enabled && snap.has_human) {
             y += 8;
             renderText(renderer, font, "Human Player:", sidebar_x, y, cyan); y += 20;
             SDL_Rect color_rect = {sidebar_x, y, 18, 18};
-            SDL_SetRenderDrawColor(renderer, human_player->color.r, human_player->color.g, human_player->color.b, 255);
+            SDL_SetRenderDrawColor(renderer, snap.human.color.r, snap.human.color.g, snap.human.color.b, 255);
             SDL_RenderFillRect(renderer, &color_rect);
-            std::string hp_info = "S:" + std::to_string(human_player->width) + " F:" + std::to_string(human_player->foodCount);
+            std::string hp_info = "S:" + std::to_string(snap.human.width) + " F:" + std::to_string(snap.human.food_count);
             renderText(renderer, font, hp_info, sidebar_x + 24, y, white); y += 20;
         }
         // After stats, print fitness/diversity/mutation info
         y += 6;
         renderText(renderer, font, "FITNESS", sidebar_x, y, yellow); y += 18;
-        renderText(renderer, font, "best: " + std::to_string(int(Player::display_best_fitness)), sidebar_x, y, white); y += 15;
-        renderText(renderer, font, "avg:  " + std::to_string(int(Player::display_avg_fitness)), sidebar_x, y, white); y += 15;
-        renderText(renderer, font, "last: " + std::to_string(int(Player::display_last_fitness)), sidebar_x, y, white); y += 15;
-        float diversity = std::round(Player::display_avg_diversity * 1000.0f) / 1000.0f;
-        float mutation = std::round(Player::display_mutation_rate * 10000.0f) / 10000.0f;
+        renderText(renderer, font, "best: " + std::to_string(int(snap.best_fitness)), sidebar_x, y, white); y += 15;
+        renderText(renderer, font, "avg:  " + std::to_string(int(snap.avg_fitness)), sidebar_x, y, white); y += 15;
+        renderText(renderer, font, "last: " + std::to_string(int(snap.last_fitness)), sidebar_x, y, white); y += 15;
+        float diversity = std::round(snap.avg_diversity * 1000.0f) / 1000.0f;
+        float mutation = std::round(snap.mutation_rate * 10000.0f) / 10000.0f;
         std::string diversity_str = std::to_string(diversity);
         diversity_str = diversity_str.substr(0, diversity_str.find(".") + 5);
         std::string mutation_str = std::to_string(mutation);
@@ -546,7 +564,7 @@ void GameApp::run() {
         renderText(renderer, font, "avg div: " + diversity_str, sidebar_x, y, white); y += 15;
         renderText(renderer, font, "mut rate: " + mutation_str, sidebar_x, y, white); y += 15;
         // --- Enhanced Settings Panel ---
-        if (paused) {
+        if (paused && !replay) {
             sliders.clear();
             toggles.clear();
             int sx = SCREEN_WIDTH/2 - 180, sw = 160, sh = 12, th = 32;
@@ -655,14 +673,18 @@ void GameApp::run() {
                     g_hunters_enabled = pending_hunters_enabled;
                     g_hunter_count = pending_hunter_count;
                     g_player_enabled = pending_player_enabled;
-                    restart_simulation();
-                    paused = false;
+                    request_restart();
+                    set_paused(false);
                 }
                 if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_r) {
-                    restart_simulation();
+                    request_restart();
                 }
             }
         }
         SDL_RenderPresent(renderer);
+        // Ticks run on the simulation thread, so the UI only needs display rate
+        Uint32 frame_ms = SDL_GetTicks() - frame_start;
+        if (frame_ms < (Uint32)UI_FRAME_MS) SDL_Delay(UI_FRAME_MS - frame_ms);
     }
+    if (sim) sim->stop();
 } 
\ No newline at end of file
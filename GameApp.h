@@ -3,8 +3,13 @@
 #include <SDL_ttf.h>
 #include <string>
 #include <vector>
+#include "Camera.h"
 #include "Game.h"
+#include "RenderBatch.h"
+#include "Replay.h"
 #include "Settings.h"
+#include "SimThread.h"
+#include "TextCache.h"
 
 class GameApp {
 public:
@@ -13,8 +18,21 @@ public:
     bool init();
     void run();
     void cleanup();
+    // World size for the next init() (defaults to the window's game area)
+    void set_world_size(int width, int height);
+    // Play back a recording instead of simulating (call before init())
+    void set_replay(const std::string& path);
 private:
-    void restart_simulation(const std::vector<std::vector<std::vector<float>>>* loaded_genes = nullptr, const std::vector<std::vector<float>>* best_gene = nullptr);
+    // Rebuilds the world; runs on the simulation thread once it is started
+    void restart_simulation(const SimSettings& settings);
+    // UI side: queue a restart / pause / speed change for the simulation thread
+    void request_restart();
+    void set_paused(bool value);
+    void set_speed_index(int index);
+    SimSettings current_settings() const;
+    // Replay playback: moves the cursor by seconds of wall time at the current speed
+    void advance_replay(double seconds);
+    void seek_replay(double tick);
     void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
     struct SidebarButton {
         SDL_Rect rect;
@@ -26,7 +44,20 @@ private:
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
     TTF_Font* font = nullptr;
+    TextCache text_cache;
     Game* game = nullptr;
+    SimThread* sim = nullptr;
+    Camera camera;
+    RenderBatch render_batch; // entity draws of a frame, submitted together
+    // Replay mode (no Game or SimThread)
+    std::string replay_path;
+    ReplayPlayer* replay = nullptr;
+    RenderSnapshot replay_snapshot;
+    double replay_cursor = 0.0; // tick being shown, fractional while playing slowly
+    SDL_Rect replay_bar = {0, 0, 0, 0}; // scrub bar in the sidebar
+    bool dragging_replay_bar = false;
+    int world_width = SCREEN_WIDTH;
+    int world_height = SCREEN_HEIGHT;
     // Simulation parameters
     int g_bot_count;
     int g_food_count;
@@ -44,10 +75,8 @@ private:
     std::vector<int> speed_steps;
     int speed_index = 0;
     int sim_speed = 1;
-    bool logic_max_mode = false;
     bool show_menu = true;
     bool show_settings = false;
+    bool show_profiler = false; // Sidebar shows per-phase tick timings instead of Top Bots
     Uint32 sim_start_time = 0;
-    Uint32 last_gene_pool_save = 0;
-    const Uint32 GENE_POOL_SAVE_INTERVAL = 5000;
 }; 
\ No newline at end of file
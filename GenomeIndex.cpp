@@ -0,0 +1,231 @@
+#include "GenomeIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr int LEAF_ROWS = 8;            // rows a leaf holds before it is split
+    constexpr int MIN_PENDING = 32;         // inserted rows scanned linearly before a rebuild...
+    constexpr size_t PENDING_FRACTION = 8;  // ...or 1/8 of the live rows, whichever is more
+    constexpr int EARLY_EXIT_STRIDE = 64;   // weights between checks of a leaf row's partial sum
+    constexpr size_t BLOCK_WEIGHTS = 32;    // weights per block sum of the lower bound
+    constexpr float SUM_SLACK = 1e-3f;      // relative; the block sums round differently from the weights
+    constexpr int PROBE_QUERIES = 16;       // queries after a build that test the tree...
+    constexpr double DEGENERATE_SHARE = 0.5; // ...which is dropped if they evaluate this share of the rows
+    constexpr float MU_SLACK = 1e-5f;       // relative; absorbs float rounding in the pruning tests
+
+    template <typename F>
+    void for_each_weight(const Player::GeneEntry& entry, F&& f) {
+        for (size_t l = 0; l < entry.genes.size(); ++l) {
+            for (float w : entry.genes[l]) f(w);
+            for (float b : entry.biases[l]) f(b);
+        }
+    }
+}
+
+void GenomeIndex::clear() {
+    dim = 0;
+    blocks = 0;
+    data.clear();
+    sums.clear();
+    dead.clear();
+    live_rows = 0;
+    nodes.clear();
+    order.clear();
+    pending.clear();
+}
+
+void GenomeIndex::append(const Player::GeneEntry& entry) {
+    if (dead.empty()) {
+        dim = 0;
+        for_each_weight(entry, [&](float) { ++dim; });
+        blocks = (dim + BLOCK_WEIGHTS - 1) / BLOCK_WEIGHTS;
+    }
+    const size_t start = data.size();
+    data.resize(start + dim, 0.0f);
+    size_t k = 0;
+    for_each_weight(entry, [&](float w) { if (k < dim) data[start + k++] = w; });
+    sums.resize(sums.size() + blocks);
+    block_sums(data.data() + start, sums.data() + sums.size() - blocks);
+    dead.push_back(0);
+    ++live_rows;
+}
+
+void GenomeIndex::build(const std::vector<Player::GeneEntry>& entries) {
+    clear();
+    for (const auto& entry : entries) append(entry);
+    rebuild_tree();
+}
+
+int GenomeIndex::insert(const Player::GeneEntry& entry) {
+    append(entry);
+    const int row = int(dead.size()) - 1;
+    pending.push_back(row);
+    if (pending.size() > std::max<size_t>(MIN_PENDING, live_rows / PENDING_FRACTION)) rebuild_tree();
+    return row;
+}
+
+void GenomeIndex::remove(int row) {
+    if (row < 0 || row >= int(dead.size()) || dead[row]) return;
+    dead[row] = 1;
+    --live_rows;
+}
+
+void GenomeIndex::rebuild_tree() {
+    nodes.clear();
+    order.clear();
+    pending.clear();
+    probe_queries.store(0, std::memory_order_relaxed);
+    probe_distances.store(0, std::memory_order_relaxed);
+    linear.store(false, std::memory_order_relaxed);
+    for (int row = 0; row < int(dead.size()); ++row) {
+        if (!dead[row]) order.push_back(row);
+    }
+    if (!order.empty()) build_node(0, int(order.size()));
+}
+
+int GenomeIndex::build_node(int begin, int end) {
+    const int index = int(nodes.size());
+    nodes.emplace_back();
+    if (end - begin <= LEAF_ROWS) {
+        nodes[index].begin = begin;
+        nodes[index].end = end;
+        return index;
+    }
+    // The first row is the vantage; the others are split at the median distance to it
+    const int vantage = order[begin];
+    scratch.clear();
+    for (int i = begin + 1; i < end; ++i) scratch.push_back({distance(vantage, order[i]), order[i]});
+    const size_t median = scratch.size() / 2;
+    std::nth_element(scratch.begin(), scratch.begin() + median, scratch.end());
+    for (size_t i = 0; i < scratch.size(); ++i) order[begin + 1 + int(i)] = scratch[i].second;
+    const float mu = scratch[median].first;
+    const int split = begin + 1 + int(median) + 1; // the median row goes inside (distance <= mu)
+    nodes[index].vantage = vantage;
+    nodes[index].mu = mu;
+    const int inside = build_node(begin + 1, split);
+    const int outside = split < end ? build_node(split, end) : -1;
+    nodes[index].inside = inside;
+    nodes[index].outside = outside;
+    return index;
+}
+
+float GenomeIndex::distance(int a, int b) const {
+    L1Lanes sum;
+    sum.add(row_data(a), row_data(b), dim);
+    return sum.total() / float(dim);
+}
+
+void GenomeIndex::block_sums(const float* weights, float* out) const {
+    for (size_t b = 0; b < blocks; ++b) {
+        float sum = 0.0f;
+        for (size_t k = b * BLOCK_WEIGHTS; k < std::min(dim, (b + 1) * BLOCK_WEIGHTS); ++k) sum += weights[k];
+        out[b] = sum;
+    }
+}
+
+float GenomeIndex::bounded_distance(const Query& query, int row, float bound) const {
+    const float limit = bound * float(dim) * (1.0f + MU_SLACK);
+    // |sum x - sum y| <= sum |x - y| over each block
+    const float* s = row_sums(row);
+    float lower = 0.0f;
+    for (size_t b = 0; b < blocks; ++b) lower += std::abs(query.sums[b] - s[b]);
+    if (lower > limit * (1.0f + SUM_SLACK)) return std::numeric_limits<float>::infinity();
+    const float* x = query.weights;
+    const float* y = row_data(row);
+    L1Lanes sum;
+    for (size_t k = 0; k < dim; k += EARLY_EXIT_STRIDE) {
+        sum.add(x + k, y + k, std::min<size_t>(EARLY_EXIT_STRIDE, dim - k));
+        if (sum.total() > limit) return std::numeric_limits<float>::infinity(); // the remaining terms only add
+    }
+    return sum.total() / float(dim);
+}
+
+int GenomeIndex::nearest(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, float& dist, float within) const {
+    std::vector<float> query;
+    query.reserve(dim);
+    for (size_t l = 0; l < genes.size() && l < biases.size(); ++l) {
+        query.insert(query.end(), genes[l].begin(), genes[l].end());
+        query.insert(query.end(), biases[l].begin(), biases[l].end());
+    }
+    if (query.size() != dim) {
+        dist = std::numeric_limits<float>::infinity();
+        return -1;
+    }
+    return nearest(query.data(), -1, dist, within);
+}
+
+int GenomeIndex::nearest(int row, float& dist, float within) const {
+    return nearest(row_data(row), row, dist, within);
+}
+
+int GenomeIndex::nearest(const float* weights, int skip, float& dist, float within) const {
+    Query query{weights, std::vector<float>(blocks), skip};
+    block_sums(weights, query.sums.data());
+    float best = within;
+    int found = -1;
+    long long count = 0;
+    auto scan = [&](int row) {
+        if (dead[row] || row == skip) return;
+        float d = bounded_distance(query, row, best);
+        ++count;
+        if (d < best) {
+            best = d;
+            found = row;
+        }
+    };
+    if (linear.load(std::memory_order_relaxed)) {
+        for (int row = 0; row < int(dead.size()); ++row) scan(row);
+    } else {
+        if (!nodes.empty()) search(0, query, best, found, count);
+        for (int row : pending) scan(row);
+        // Enough probes that evaluated most rows: the tree is not worth its overhead
+        if (probe_queries.load(std::memory_order_relaxed) < PROBE_QUERIES) {
+            const long long probes = probe_queries.fetch_add(1, std::memory_order_relaxed) + 1;
+            const long long probed = probe_distances.fetch_add(count, std::memory_order_relaxed) + count;
+            if (probes == PROBE_QUERIES && double(probed) > DEGENERATE_SHARE * PROBE_QUERIES * double(live_rows)) {
+                linear.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+    evaluated.fetch_add(count, std::memory_order_relaxed);
+    dist = best;
+    return found;
+}
+
+void GenomeIndex::search(int index, const Query& query, float& best, int& found, long long& count) const {
+    const Node& node = nodes[index];
+    if (node.vantage < 0) {
+        for (int i = node.begin; i < node.end; ++i) {
+            const int row = order[i];
+            if (dead[row] || row == query.skip) continue;
+            float d = bounded_distance(query, row, best);
+            ++count;
+            if (d < best) {
+                best = d;
+                found = row;
+            }
+        }
+        return;
+    }
+    // The vantage row's distance routes the query, even when the row itself was removed. Past
+    // mu + best only the outside can hold anything closer, so the distance is cut short there.
+    const float d = bounded_distance(query, node.vantage, node.mu + best);
+    ++count;
+    if (!dead[node.vantage] && node.vantage != query.skip && d < best) {
+        best = d;
+        found = node.vantage;
+    }
+    // Inside holds rows within mu of the vantage, outside rows at mu or more; a side can only
+    // hold a row closer than best if |d - mu| < best
+    const float slack = MU_SLACK * (d + node.mu);
+    auto visit_inside = [&] { if (node.inside >= 0 && d - best <= node.mu + slack) search(node.inside, query, best, found, count); };
+    auto visit_outside = [&] { if (node.outside >= 0 && d + best >= node.mu - slack) search(node.outside, query, best, found, count); };
+    if (d <= node.mu) {
+        visit_inside();
+        visit_outside();
+    } else {
+        visit_outside();
+        visit_inside();
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Player.h"
+
+// Sum of |x - y| over a genome's weights, term k going to running sum k % LANES, so
+// consecutive terms do not wait on each other. Player::genetic_distance and GenomeIndex both
+// sum through it, in the same order, so their distances agree bit for bit.
+struct L1Lanes {
+    static constexpr int LANES = 8;
+    std::array<float, LANES> lane{};
+    size_t next = 0; // index of the next term
+    // Appends n terms
+    void add(const float* x, const float* y, size_t n) {
+        size_t i = 0;
+        for (; i < n && next % LANES != 0; ++i, ++next) lane[next % LANES] += std::abs(x[i] - y[i]);
+        for (; i + LANES <= n; i += LANES, next += LANES) {
+            #pragma omp simd
+            for (int j = 0; j < LANES; ++j) lane[j] += std::abs(x[i + j] - y[i + j]);
+        }
+        for (; i < n; ++i, ++next) lane[next % LANES] += std::abs(x[i] - y[i]);
+    }
+    float total() const { return ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7])); }
+};
+
+// Nearest-neighbour index over genomes under Player::genetic_distance (the mean absolute
+// difference of all weights and biases, a metric). Each genome is stored as one flat row in
+// genetic_distance's order and summed through L1Lanes, so distances are bit-identical to it.
+// The rows are organised as a vantage-point tree: a node splits its rows at the median distance
+// mu to a vantage row, and a query only descends into a side that can still hold something
+// closer than its best so far (triangle inequality). Leaves hold a few rows, scanned with an
+// early exit once the partial distance passes the best. Before that, each row is checked against
+// a cheap lower bound: the differences of its block sums (blocks of BLOCK_WEIGHTS weights), which
+// can only be smaller than the sum of the weights' differences.
+// Rows can be removed (they stay in the tree, skipped) and inserted (scanned linearly until
+// enough have piled up to rebuild the tree), so an index survives a pool's churn.
+// When genomes differ by similar amounts in every weight, their distances concentrate and the
+// tree prunes almost nothing. If the first queries after a build evaluate most rows, the
+// index stops descending the tree and scans every live row, which costs less.
+class GenomeIndex {
+public:
+    // Row i is entries[i]; all entries must have the same layout
+    void build(const std::vector<Player::GeneEntry>& entries);
+    void clear();
+    // Appends a row and returns it
+    int insert(const Player::GeneEntry& entry);
+    void remove(int row);
+    bool removed(int row) const { return dead[row] != 0; }
+    size_t rows() const { return dead.size(); }
+    size_t live() const { return live_rows; }
+    float distance(int a, int b) const;
+    // Nearest live row closer than within to a genome, or to row (itself excluded); -1 if there
+    // is none. dist receives its distance. Safe to call from several threads at once.
+    int nearest(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, float& dist,
+                float within = std::numeric_limits<float>::infinity()) const;
+    int nearest(int row, float& dist, float within = std::numeric_limits<float>::infinity()) const;
+    // Distances evaluated by the queries since construction (leaf rows cut short included)
+    long long distances() const { return evaluated.load(std::memory_order_relaxed); }
+    // The tree was found degenerate since the last build; queries scan every live row
+    bool scanning() const { return linear.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        int vantage = -1;        // -1 = leaf
+        float mu = 0.0f;         // rows at distance <= mu from the vantage row go inside
+        int inside = -1, outside = -1;
+        int begin = 0, end = 0;  // leaf: its rows in order
+    };
+
+    void append(const Player::GeneEntry& entry);
+    void rebuild_tree();
+    int build_node(int begin, int end);
+    struct Query {
+        const float* weights;
+        std::vector<float> sums; // per block
+        int skip;
+    };
+    int nearest(const float* query, int skip, float& dist, float within) const;
+    void search(int node, const Query& query, float& best, int& found, long long& count) const;
+    // Distance to row, or +inf once a lower bound or the partial sum shows it is beyond bound
+    float bounded_distance(const Query& query, int row, float bound) const;
+    const float* row_data(int row) const { return data.data() + size_t(row) * dim; }
+    const float* row_sums(int row) const { return sums.data() + size_t(row) * blocks; }
+    void block_sums(const float* weights, float* out) const;
+
+    size_t dim = 0;
+    size_t blocks = 0;
+    std::vector<float> data;      // rows x dim
+    std::vector<float> sums;      // rows x blocks
+    std::vector<uint8_t> dead;
+    size_t live_rows = 0;
+    std::vector<Node> nodes;      // nodes[0] is the root
+    std::vector<int> order;       // rows of the tree, leaves' rows contiguous
+    std::vector<int> pending;     // rows inserted since the tree was built, scanned linearly
+    std::vector<std::pair<float, int>> scratch; // build: distances to the vantage row
+    mutable std::atomic<long long> evaluated{0};
+    // The first queries after a build, which decide whether the tree is worth descending
+    mutable std::atomic<long long> probe_queries{0}, probe_distances{0};
+    mutable std::atomic<bool> linear{false};
+};
@@ -0,0 +1,48 @@
+#include "Headless.h"
+#include "Game.h"
+#include "Player.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+
+void populate_headless(Game& game, const HeadlessConfig& config) {
+    sim_srand(config.seed != 0 ? config.seed : static_cast<unsigned int>(time(nullptr)));
+    game.reset();
+    game.set_world_size(config.world_width, config.world_height);
+    game.lod.interval = std::max(1, config.lod_interval);
+    for (int i = 0; i < config.bots; ++i) {
+        auto [genes, biases] = random_genes_and_biases();
+        SDL_Color color = {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
+        game.newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
+    }
+    if (config.hunters > 0) {
+        game.newHunter(config.hunters, HUNTER_WIDTH, HUNTER_HEIGHT, HUNTER_COLOR, SPEED, false, false);
+    }
+    game.randomFood(config.foods);
+}
+
+HeadlessResult run_headless(Game& game, const HeadlessConfig& config, const std::function<bool(Game&, long long)>& on_tick) {
+    HeadlessResult result;
+    std::unique_ptr<MetricsSink> metrics;
+    if (!config.metrics.path.empty()) metrics = std::make_unique<MetricsSink>(config.metrics);
+    std::unique_ptr<ReplayRecorder> recorder;
+    if (!config.record.path.empty()) {
+        recorder = std::make_unique<ReplayRecorder>(config.record, game.width, game.height);
+        recorder->record(game, 0);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (long long tick = 1; tick <= config.ticks; ++tick) {
+        game.update();
+        result.ticks = tick;
+        if (metrics) metrics->on_tick(game, tick);
+        if (recorder) recorder->on_tick(game, tick);
+        if (on_tick && !on_tick(game, tick)) break;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.ticks_per_second = result.seconds > 0.0 ? result.ticks / result.seconds : 0.0;
+    result.best_fitness = Player::gene_pool.empty() ? 0.0f : Player::gene_pool.front().fitness;
+    return result;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include "Settings.h"
+#include "Metrics.h"
+#include "Replay.h"
+class Game;
+
+// Configuration for running the simulation without a window
+struct HeadlessConfig {
+    int bots = MIN_BOT;
+    int foods = NUMBER_OF_FOODS;
+    int hunters = HUNTERS;
+    int world_width = SCREEN_WIDTH; // the world can be far larger than the window
+    int world_height = SCREEN_HEIGHT;
+    long long ticks = 100000;
+    unsigned int seed = 0; // 0 = seed from the clock
+    int lod_interval = LOD_SCHEDULING ? LOD_INTERVAL : 1; // see LodScheduler; 1 = off
+    MetricsConfig metrics; // streamed while running when metrics.path is set
+    ReplayConfig record;   // replay written while running when record.path is set
+};
+
+struct HeadlessResult {
+    long long ticks = 0;
+    double seconds = 0.0;
+    double ticks_per_second = 0.0;
+    float best_fitness = 0.0f; // best fitness in the gene pool at the end of the run
+};
+
+// Clears the game and spawns bots, hunters and food as described by config
+void populate_headless(Game& game, const HeadlessConfig& config);
+// Runs config.ticks updates as fast as possible. on_tick is called after every update
+// with the number of completed ticks; returning false stops the run early.
+HeadlessResult run_headless(Game& game, const HeadlessConfig& config, const std::function<bool(Game&, long long)>& on_tick = nullptr);
@@ -4,67 +4,42 @@
 #include <algorithm>
 #include "Food.h"
 #include "Player.h"
+#include "Tunables.h"
+#include "Random.h"
+#include "FastMath.h"
 
 constexpr float HUNTER_SPEED = 0.2f;
 
 Hunter::Hunter(int width, int height, SDL_Color color, float x, float y, float speed, bool alive)
     : Player(width, height, color, x, y, alive), movetime(0), keys{0,0,0,0} {
     this->speed = HUNTER_SPEED;
+    is_hunter = true;
 }
 
 void Hunter::update(Game& game) {
-    // Find which players are already targeted by other hunters
+    auto is_prey = [](const Player* p) {
+        return p->alive && dynamic_cast<const Hunter*>(p) == nullptr;
+    };
+    // Find which players are already targeted by other hunters (the closest prey of each)
     std::vector<Player*> already_targeted;
     for (auto* h : game.hunters) {
         if (h == this) continue;
-        // Find the closest player for this hunter (if any)
-        Player* h_target = nullptr;
         float h_min_dist = 1e9f;
-        for (auto* p : game.players) {
-            if (p == h || !p->alive) continue;
-            if (dynamic_cast<Hunter*>(p) != nullptr) continue;
-            float dx = p->x - h->x;
-            float dy = p->y - h->y;
-            float dist = dx*dx + dy*dy;
-            if (dist < h_min_dist) {
-                h_min_dist = dist;
-                h_target = p;
-            }
-        }
+        Player* h_target = game.nearest_player_if(h->x, h->y, is_prey, h_min_dist);
         if (h_target) already_targeted.push_back(h_target);
     }
+    // Only target players the hunter can eat - so they won't aimlessly chase a bigger player
+    auto can_eat = [&](const Player* p) {
+        return is_prey(p) && height > p->height * 1.2f;
+    };
     // Now pick the nearest player not already targeted
-    Player* target = nullptr;
     float min_dist = 1e9f;
-    for (auto* p : game.players) {
-        if (p == this || !p->alive) continue;
-        if (dynamic_cast<Hunter*>(p) != nullptr) continue;
-        if (std::find(already_targeted.begin(), already_targeted.end(), p) != already_targeted.end()) continue;
-        // Only target players the hunter can eat - so they won't aimlessly chase a bigger player
-        if (height <= p->height * 1.2f) continue;
-        float dx = p->x - x;
-        float dy = p->y - y;
-        float dist = dx*dx + dy*dy;
-        if (dist < min_dist) {
-            min_dist = dist;
-            target = p;
-        }
-    }
+    Player* target = game.nearest_player_if(x, y, [&](const Player* p) {
+        return can_eat(p) && std::find(already_targeted.begin(), already_targeted.end(), p) == already_targeted.end();
+    }, min_dist);
     // If all players are already targeted, fallback to nearest the hunter can eat
     if (!target) {
-        for (auto* p : game.players) {
-            if (p == this || !p->alive) continue;
-            if (dynamic_cast<Hunter*>(p) != nullptr) continue;
-            // Only target players the hunter can eat
-            if (height <= p->height * 1.2f) continue;
-            float dx = p->x - x;
-            float dy = p->y - y;
-            float dist = dx*dx + dy*dy;
-            if (dist < min_dist) {
-                min_dist = dist;
-                target = p;
-            }
-        }
+        target = game.nearest_player_if(x, y, can_eat, min_dist);
     }
     if (target) {
         float dx = target->x - x;
@@ -72,30 +47,21 @@ void Hunter::update(Game& game) {
         float d = std::sqrt(dx*dx + dy*dy);
         if (d > 1e-3f) {
             // Add a bit of noise to the direction
-            float angle = std::atan2(dy, dx);
-            float noise = (((float)rand() / RAND_MAX) - 0.5f) * 0.4f; // noise in [-0.2, 0.2] radians
+            float angle = sim_atan2(dy, dx);
+            float noise = (((float)sim_rand() / SIM_RAND_MAX) - 0.5f) * 0.4f; // noise in [-0.2, 0.2] radians
             angle += noise;
-            float vx = std::cos(angle) * speed;
-            float vy = std::sin(angle) * speed;
+            float sin_angle, cos_angle;
+            sim_sincos(angle, sin_angle, cos_angle);
+            float vx = cos_angle * speed;
+            float vy = sin_angle * speed;
             x += vx;
             y += vy;
         }
     }
     // Clamp to screen using Player's method
     clamp_to_screen(game);
-    // Eating logic
+    // Eating logic; prey is eaten in Game's collision phase
     eatFood(game);
-    for (auto* other : game.players) {
-        if (other->alive && other != this) {
-            eatPlayer(game, *other);
-        }
-    }
-}
-
-void Hunter::draw(SDL_Renderer* renderer) {
-    SDL_Rect rect = {static_cast<int>(x - width / 2.0f), static_cast<int>(y - height / 2.0f), width, height};
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Red
-    SDL_RenderFillRect(renderer, &rect);
 }
 
 bool Hunter::eatPlayer(Game& game, Player& other) {
@@ -103,12 +69,12 @@ bool Hunter::eatPlayer(Game& game, Player& other) {
     if (collide(other) && height > other.height * 1.2f) {
         playerEaten++;
         killTime = 0;
-        other.alive = false;
+        game.kill_player(other);
         // Do NOT increase size or foodCount
         // Replenish population if needed
-        if (std::count_if(game.players.begin(), game.players.end(), [](Player* p){ return p->alive; }) <= MIN_BOT) {
+        if (game.population.alive() <= g_tunables.min_bot) {
             auto [genes, biases] = random_genes_and_biases();
-            SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
+            SDL_Color color = {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
             game.newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
         }
         return true;
@@ -0,0 +1,200 @@
+#include "Island.h"
+#include "Game.h"
+#include "Player.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <ctime>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define ISLANDS_SUPPORTED 1
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Atomics in shared memory are only safe across processes when they are lock-free
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "MigrationRing needs lock-free 32-bit atomics");
+static_assert(std::atomic<long long>::is_always_lock_free, "IslandStatus needs lock-free 64-bit atomics");
+
+void MigrationRing::init() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+}
+
+bool MigrationRing::push(const std::vector<char>& data) {
+    if (data.size() > SLOT_BYTES) return false;
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= SLOTS) return false;
+    uint32_t slot = t % SLOTS;
+    std::memcpy(slots[slot], data.data(), data.size());
+    sizes[slot] = static_cast<uint32_t>(data.size());
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+bool MigrationRing::pop(std::vector<char>& data) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    uint32_t slot = h % SLOTS;
+    data.assign(slots[slot], slots[slot] + sizes[slot]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+#ifdef ISLANDS_SUPPORTED
+namespace {
+    std::string island_pool_file(int island) {
+        return "gene_pool_island" + std::to_string(island) + ".txt";
+    }
+
+    std::string island_hall_of_fame_file(int island) {
+        return "hall_of_fame_island" + std::to_string(island) + ".txt";
+    }
+
+    void pin_to_cpu(int island) {
+#ifdef __linux__
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus <= 0) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(island % cpus, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "[island " << island << "] could not pin to cpu " << island % cpus << std::endl;
+        }
+#endif
+    }
+
+    // Body of an island process; never returns to the caller's stack
+    [[noreturn]] void island_main(int island, const IslandConfig& config, MigrationRing* rings, IslandStatus* status) {
+        if (config.pin_cpus) pin_to_cpu(island);
+        Player::hall_of_fame_file = island_hall_of_fame_file(island);
+        HeadlessConfig sim = config.sim;
+        if (!sim.metrics.path.empty()) sim.metrics.path += ".island" + std::to_string(island);
+        if (!sim.record.path.empty()) sim.record.path += ".island" + std::to_string(island);
+        sim.seed = (config.sim.seed != 0 ? config.sim.seed : static_cast<unsigned int>(time(nullptr))) + 7919u * island;
+        MigrationRing& inbox = rings[island];
+        MigrationRing& outbox = rings[(island + 1) % config.islands];
+        IslandStatus& own = status[island];
+        Game game(nullptr);
+        populate_headless(game, sim);
+        std::vector<char> buffer;
+        run_headless(game, sim, [&](Game&, long long tick) {
+            if (config.migration_interval > 0 && tick % config.migration_interval == 0) {
+                // Emigrate the best entries (pool is kept sorted by fitness)
+                int n = std::min<int>(config.migrants, Player::gene_pool.size());
+                for (int i = 0; i < n; ++i) {
+                    Player::write_gene_entry_binary(Player::gene_pool[i], buffer);
+                    if (outbox.push(buffer)) own.migrants_sent.fetch_add(1, std::memory_order_relaxed);
+                }
+                // Immigrate whatever the previous island sent us
+                Player::GeneEntry entry;
+                while (inbox.pop(buffer)) {
+                    if (Player::read_gene_entry_binary(buffer.data(), buffer.size(), entry)) {
+                        Player::try_insert_gene_to_pool(entry.fitness, entry.genes, entry.biases);
+                        own.migrants_received.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+            if (tick % 1000 == 0) {
+                own.ticks.store(tick, std::memory_order_relaxed);
+                own.best_fitness.store(Player::gene_pool.empty() ? 0.0f : Player::gene_pool.front().fitness, std::memory_order_relaxed);
+            }
+            return true;
+        });
+        own.ticks.store(config.sim.ticks, std::memory_order_relaxed);
+        Player::save_gene_pool(island_pool_file(island));
+        _exit(0);
+    }
+}
+
+int run_islands(const IslandConfig& config) {
+    if (config.islands < 1) return 0;
+    size_t ring_bytes = sizeof(MigrationRing) * config.islands;
+    size_t status_bytes = sizeof(IslandStatus) * config.islands;
+    void* shared = mmap(nullptr, ring_bytes + status_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        std::cerr << "Could not map shared memory for islands" << std::endl;
+        return config.islands;
+    }
+    MigrationRing* rings = static_cast<MigrationRing*>(shared);
+    IslandStatus* status = reinterpret_cast<IslandStatus*>(static_cast<char*>(shared) + ring_bytes);
+    for (int i = 0; i < config.islands; ++i) {
+        new (&rings[i]) MigrationRing();
+        rings[i].init();
+        new (&status[i]) IslandStatus{{0}, {0.0f}, {0}, {0}};
+    }
+    std::cout.flush();
+    std::vector<pid_t> pids(config.islands, -1);
+    for (int i = 0; i < config.islands; ++i) {
+        // No file of an earlier run may stand in for an island that dies before saving
+        std::remove(island_pool_file(i).c_str());
+        std::remove(island_hall_of_fame_file(i).c_str());
+        pid_t pid = fork();
+        if (pid == 0) island_main(i, config, rings, status);
+        if (pid < 0) std::cerr << "Could not fork island " << i << std::endl;
+        pids[i] = pid;
+    }
+    // Wait for every island; a crashing island only loses its own progress
+    std::vector<bool> succeeded(config.islands, false);
+    int failed = 0;
+    int running = 0;
+    for (pid_t pid : pids) if (pid > 0) ++running;
+    failed += config.islands - running;
+    while (running > 0) {
+        int wstatus = 0;
+        pid_t done = waitpid(-1, &wstatus, WNOHANG);
+        if (done > 0) {
+            int island = int(std::find(pids.begin(), pids.end(), done) - pids.begin());
+            if (island >= config.islands) continue;
+            --running;
+            if (WIFSIGNALED(wstatus)) {
+                std::cerr << "[island " << island << "] crashed with signal " << WTERMSIG(wstatus) << std::endl;
+                ++failed;
+            } else if (WEXITSTATUS(wstatus) != 0) {
+                std::cerr << "[island " << island << "] exited with status " << WEXITSTATUS(wstatus) << std::endl;
+                ++failed;
+            } else {
+                succeeded[island] = true;
+            }
+            continue;
+        }
+        std::cout << "[islands]";
+        for (int i = 0; i < config.islands; ++i) {
+            std::cout << "  #" << i << " " << status[i].ticks.load() / 1000 << "k best " << std::fixed << std::setprecision(0) << status[i].best_fitness.load();
+        }
+        std::cout << std::endl;
+        sleep(1);
+    }
+    for (int i = 0; i < config.islands; ++i) {
+        std::cout << "[island " << i << "] sent " << status[i].migrants_sent.load() << ", received " << status[i].migrants_received.load() << std::endl;
+    }
+    munmap(shared, ring_bytes + status_bytes);
+    // Merge the gene pools of the islands that finished into the parent pool
+    std::vector<Player::GeneEntry> merged = Player::gene_pool;
+    for (int i = 0; i < config.islands; ++i) {
+        if (succeeded[i]) {
+            Player::load_gene_pool(island_pool_file(i));
+            merged.insert(merged.end(), Player::gene_pool.begin(), Player::gene_pool.end());
+        }
+        std::remove(island_pool_file(i).c_str());
+        std::remove(island_hall_of_fame_file(i).c_str());
+    }
+    Player::gene_pool.clear();
+    Player::gene_pool_changed();
+    for (const auto& entry : merged) Player::try_insert_gene_to_pool(entry.fitness, entry.genes, entry.biases);
+    return failed;
+}
+#else
+int run_islands(const IslandConfig& config) {
+    std::cerr << "Islands require fork() and shared memory, which are not available on this platform" << std::endl;
+    return -1;
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Settings.h"
+#include "Headless.h"
+
+// Island model: every island is a separate headless simulation process with its own
+// Player:: statics. Islands are arranged in a ring and periodically send their best
+// genomes (binary genome format) to the next island through shared memory.
+struct IslandConfig {
+    int islands = 4;
+    int migration_interval = ISLAND_MIGRATION_INTERVAL;
+    int migrants = ISLAND_MIGRANTS;
+    bool pin_cpus = false; // pin island i to cpu i % cpu_count (Linux only)
+    HeadlessConfig sim;
+};
+
+// Single-producer/single-consumer ring buffer placed in shared memory.
+// Island i pushes into ring (i + 1) % islands and pops from ring i.
+struct MigrationRing {
+    static constexpr uint32_t SLOTS = ISLAND_RING_SLOTS;
+    static constexpr uint32_t SLOT_BYTES = ISLAND_RING_SLOT_BYTES;
+    std::atomic<uint32_t> head; // next slot to read (consumer)
+    std::atomic<uint32_t> tail; // next slot to write (producer)
+    uint32_t sizes[SLOTS];
+    char slots[SLOTS][SLOT_BYTES];
+
+    void init();
+    bool push(const std::vector<char>& data); // false if the ring is full or data does not fit a slot
+    bool pop(std::vector<char>& data); // false if the ring is empty
+};
+
+// Per-island progress, written by the island and read by the parent process
+struct IslandStatus {
+    std::atomic<long long> ticks;
+    std::atomic<float> best_fitness;
+    std::atomic<int> migrants_sent;
+    std::atomic<int> migrants_received;
+};
+
+// Forks config.islands processes, waits for them and merges their gene pools into
+// the parent's gene pool. Returns the number of islands that did not exit cleanly,
+// or -1 if islands are not supported on this platform.
+int run_islands(const IslandConfig& config);
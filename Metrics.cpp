@@ -0,0 +1,193 @@
+#include "Metrics.h"
+#include "Game.h"
+#include "Player.h"
+#include "ThreadPool.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Column/key name of a phase: the profiler name without its sub-phase indent
+    std::string phase_key(int phase) {
+        std::string name = TickProfiler::phase_name(static_cast<ProfilePhase>(phase));
+        return name.substr(name.find_first_not_of(' '));
+    }
+
+    // Opens path for writing. A named pipe is opened without waiting for a reader: with none
+    // attached this returns nullptr and sets no_reader, and the caller tries again later
+    std::FILE* open_stream(const std::string& path, bool& no_reader) {
+        no_reader = false;
+#ifndef _WIN32
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0 && S_ISFIFO(info.st_mode)) {
+            const int fd = open(path.c_str(), O_WRONLY | O_NONBLOCK);
+            if (fd < 0) {
+                no_reader = errno == ENXIO;
+                return nullptr;
+            }
+            // Once connected, writes may wait for the reader: that is what the writer thread is for
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            std::FILE* file = fdopen(fd, "w");
+            if (!file) close(fd);
+            return file;
+        }
+#endif
+        return std::fopen(path.c_str(), "w");
+    }
+}
+
+MetricsFormat metrics_format_from_path(const std::string& path) {
+    const std::string ext = ".csv";
+    if (path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0) return MetricsFormat::Csv;
+    return MetricsFormat::Jsonl;
+}
+
+MetricsSink::MetricsSink(const MetricsConfig& config) : config(config), last_time(std::chrono::steady_clock::now()) {
+#ifdef SIGPIPE
+    // A named pipe whose reader went away should end the stream, not the process
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    writer = std::thread(&MetricsSink::writer_loop, this);
+}
+
+MetricsSink::~MetricsSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    if (dropped_records > 0) {
+        std::cerr << "metrics: dropped " << dropped_records << " records (writer fell behind)" << std::endl;
+    }
+}
+
+void MetricsSink::on_tick(const Game& game, long long tick) {
+    if (config.interval <= 0 || tick % config.interval != 0) return;
+    MetricsRecord record;
+    record.tick = tick;
+    record.alive_bots = game.population.bots;
+    record.best_fitness = Player::display_best_fitness;
+    record.avg_fitness = Player::display_avg_fitness;
+    record.last_fitness = Player::display_last_fitness;
+    record.avg_diversity = Player::display_avg_diversity;
+    record.mutation_rate = Player::adaptive_mutation_rate;
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last_time).count();
+    record.ticks_per_second = seconds > 0.0 ? (tick - last_tick) / seconds : 0.0;
+    last_tick = tick;
+    last_time = now;
+    record.lod_reduced = game.lod.reduced_fraction(last_lod_full, last_lod_reduced);
+    last_lod_full = game.lod.full;
+    last_lod_reduced = game.lod.reduced;
+    const PoolStats pool = ThreadPool::shared().stats();
+    const double pool_wall = pool.wall_seconds - last_pool_wall;
+    record.pool_utilization = pool_wall > 0.0 ? float((pool.busy_seconds - last_pool_busy) / (pool_wall * pool.threads)) : 0.0f;
+    last_pool_busy = pool.busy_seconds;
+    last_pool_wall = pool.wall_seconds;
+    for (int i = 0; i < TickProfiler::PHASES; ++i) {
+        record.phase_p50_us[i] = TickProfiler::percentile_us(static_cast<ProfilePhase>(i), 0.5f);
+        record.phase_p99_us[i] = TickProfiler::percentile_us(static_cast<ProfilePhase>(i), 0.99f);
+    }
+    push(record);
+}
+
+void MetricsSink::push(const MetricsRecord& record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ((int)queue.size() >= METRICS_QUEUE_CAPACITY) {
+            queue.pop_front();
+            ++dropped_records;
+        }
+        queue.push_back(record);
+    }
+    wake.notify_one();
+}
+
+long long MetricsSink::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped_records;
+}
+
+void MetricsSink::writer_loop() {
+    // Opened here, and a named pipe without blocking, so neither the simulation nor shutdown
+    // waits for a reader
+    bool no_reader = false;
+    std::FILE* out = open_stream(config.path, no_reader);
+    if (no_reader) std::cerr << "metrics: no reader attached to " << config.path << ", records are discarded until one is" << std::endl;
+    else if (!out) std::cerr << "metrics: could not open " << config.path << std::endl;
+    bool header_pending = config.format == MetricsFormat::Csv;
+    long long unread = 0; // records discarded while no reader was attached
+    std::vector<MetricsRecord> batch;
+    std::string text;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty() && stopping) break;
+            batch.assign(queue.begin(), queue.end());
+            queue.clear();
+        }
+        if (!out && no_reader) {
+            out = open_stream(config.path, no_reader);
+            if (out) std::cerr << "metrics: reader attached to " << config.path << std::endl;
+        }
+        if (!out) {
+            if (no_reader) unread += (long long)batch.size();
+            continue;
+        }
+        text.clear();
+        if (header_pending) text += format_header() + '\n';
+        header_pending = false;
+        for (const auto& record : batch) text += format_record(record);
+        if (std::fwrite(text.data(), 1, text.size(), out) != text.size() || std::fflush(out) != 0) {
+            std::cerr << "metrics: write to " << config.path << " failed, stream closed" << std::endl;
+            std::fclose(out);
+            out = nullptr;
+        }
+    }
+    if (out) std::fclose(out);
+    if (unread > 0) std::cerr << "metrics: " << unread << " records discarded while no reader was attached to " << config.path << std::endl;
+}
+
+std::string MetricsSink::format_header() const {
+    std::string header = "tick,alive_bots,best_fitness,avg_fitness,last_fitness,avg_diversity,mutation_rate,ticks_per_second,lod_reduced,pool_utilization";
+    for (int i = 0; i < TickProfiler::PHASES; ++i) {
+        header += "," + phase_key(i) + "_p50_us," + phase_key(i) + "_p99_us";
+    }
+    return header;
+}
+
+std::string MetricsSink::format_record(const MetricsRecord& r) const {
+    char buf[320];
+    std::string line;
+    if (config.format == MetricsFormat::Csv) {
+        snprintf(buf, sizeof(buf), "%lld,%d,%.2f,%.2f,%.2f,%.4f,%.5f,%.1f,%.4f,%.4f",
+                 r.tick, r.alive_bots, r.best_fitness, r.avg_fitness, r.last_fitness, r.avg_diversity, r.mutation_rate, r.ticks_per_second, r.lod_reduced,
+                 r.pool_utilization);
+        line = buf;
+        for (int i = 0; i < TickProfiler::PHASES; ++i) {
+            snprintf(buf, sizeof(buf), ",%.1f,%.1f", r.phase_p50_us[i], r.phase_p99_us[i]);
+            line += buf;
+        }
+    } else {
+        snprintf(buf, sizeof(buf), "{\"tick\":%lld,\"alive_bots\":%d,\"best_fitness\":%.2f,\"avg_fitness\":%.2f,\"last_fitness\":%.2f,"
+                 "\"avg_diversity\":%.4f,\"mutation_rate\":%.5f,\"ticks_per_second\":%.1f,\"lod_reduced\":%.4f,\"pool_utilization\":%.4f,\"phases_us\":{",
+                 r.tick, r.alive_bots, r.best_fitness, r.avg_fitness, r.last_fitness, r.avg_diversity, r.mutation_rate, r.ticks_per_second, r.lod_reduced,
+                 r.pool_utilization);
+        line = buf;
+        for (int i = 0; i < TickProfiler::PHASES; ++i) {
+            snprintf(buf, sizeof(buf), "%s\"%s\":[%.1f,%.1f]", i ? "," : "", phase_key(i).c_str(), r.phase_p50_us[i], r.phase_p99_us[i]);
+            line += buf;
+        }
+        line += "}}";
+    }
+    return line + '\n';
+}
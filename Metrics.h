@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Settings.h"
+#include "Profiler.h"
+class Game;
+
+enum class MetricsFormat { Jsonl, Csv };
+
+// Where and how often run statistics are streamed (empty path = off)
+struct MetricsConfig {
+    std::string path;
+    MetricsFormat format = MetricsFormat::Jsonl;
+    long long interval = METRICS_INTERVAL; // ticks between records
+};
+
+// Picks CSV for *.csv paths and JSON lines otherwise
+MetricsFormat metrics_format_from_path(const std::string& path);
+
+struct MetricsRecord {
+    long long tick = 0;
+    int alive_bots = 0;
+    float best_fitness = 0.0f;
+    float avg_fitness = 0.0f;
+    float last_fitness = 0.0f;
+    float avg_diversity = 0.0f;
+    float mutation_rate = 0.0f;
+    double ticks_per_second = 0.0;
+    float lod_reduced = 0.0f; // share of bot updates at the reduced LOD rate since the previous record
+    float pool_utilization = 0.0f; // share of the thread pool's thread time spent on tasks since the previous record
+    std::array<float, TickProfiler::PHASES> phase_p50_us{}; // zero when the profiler is compiled out
+    std::array<float, TickProfiler::PHASES> phase_p99_us{};
+};
+
+// Streams MetricsRecords to a file or named pipe. The simulation thread only copies a
+// record into a bounded queue; a background thread formats and writes it, so a slow
+// reader never stalls the simulation (the oldest queued records are dropped instead).
+class MetricsSink {
+public:
+    explicit MetricsSink(const MetricsConfig& config);
+    ~MetricsSink(); // writes what is still queued, then joins the writer
+    MetricsSink(const MetricsSink&) = delete;
+    MetricsSink& operator=(const MetricsSink&) = delete;
+
+    // Samples the game every config.interval ticks
+    void on_tick(const Game& game, long long tick);
+    void push(const MetricsRecord& record);
+    long long dropped() const;
+
+private:
+    void writer_loop();
+    std::string format_header() const;
+    std::string format_record(const MetricsRecord& record) const;
+
+    MetricsConfig config;
+    std::thread writer;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<MetricsRecord> queue;
+    bool stopping = false;
+    long long dropped_records = 0;
+    // Throughput since the previous record
+    long long last_tick = 0;
+    long long last_lod_full = 0, last_lod_reduced = 0;
+    double last_pool_busy = 0.0, last_pool_wall = 0.0; // PoolStats seconds
+    std::chrono::steady_clock::time_point last_time;
+};
@@ -0,0 +1,232 @@
+#include "Novelty.h"
+#include "Game.h"
+#include "Player.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "Tunables.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+    constexpr int LEAF_ROWS = 8;         // rows a leaf holds before it is split
+    constexpr size_t MIN_RECENT = 256;   // recent rows before the main tree is rebuilt...
+    constexpr size_t RECENT_FRACTION = 8; // ...or 1/8 of the archive, whichever is more
+    // Estimated float ops of one k-nearest query over a few trees of a large archive
+    constexpr double QUERY_WORK = 64.0 * NOVELTY_K * NOVELTY_DIMS;
+
+    float squared_distance(const float* a, const float* b) {
+        float sum = 0.0f;
+        for (int k = 0; k < NOVELTY_DIMS; ++k) {
+            const float d = a[k] - b[k];
+            sum += d * d;
+        }
+        return sum;
+    }
+}
+
+BehaviorDescriptor behavior_descriptor(const Player& p, int world_width, int world_height) {
+    BehaviorDescriptor d{};
+    const int cell = Game::CELL_SIZE;
+    const int columns = std::max(1, world_width / cell), rows = std::max(1, world_height / cell);
+    if (!p.visited_cells.empty()) {
+        const float share = 1.0f / float(p.visited_cells.size());
+        for (const auto& [cx, cy] : p.visited_cells) {
+            const int gx = std::min(NOVELTY_FOOTPRINT_GRID - 1, cx * NOVELTY_FOOTPRINT_GRID / columns);
+            const int gy = std::min(NOVELTY_FOOTPRINT_GRID - 1, cy * NOVELTY_FOOTPRINT_GRID / rows);
+            d[gy * NOVELTY_FOOTPRINT_GRID + gx] += share;
+        }
+    }
+    int k = NOVELTY_FOOTPRINT_CELLS;
+    const float moved = p.distance_traveled / float(cell);
+    d[k++] = moved > 0.0f ? std::min(1.0f, float(p.visited_cells.size()) / moved) : 0.0f;
+    d[k++] = p.lifeTime > 0 ? std::min(1.0f, p.distance_traveled / (float(p.lifeTime) * MAX_SPEED)) : 0.0f;
+    const int meals = p.totalPlayersEaten + p.totalFoodEaten;
+    d[k++] = meals > 0 ? float(p.totalPlayersEaten) / float(meals) : 0.0f;
+    return d;
+}
+
+// The k nearest offered so far, nearest first, by squared distance
+struct NoveltySearch::Neighbours {
+    std::array<float, NOVELTY_K> dist;
+    int count = 0;
+    float worst() const { return count < NOVELTY_K ? std::numeric_limits<float>::infinity() : dist[NOVELTY_K - 1]; }
+    void offer(float d) {
+        if (d >= worst()) return;
+        int i = std::min(count, NOVELTY_K - 1);
+        for (; i > 0 && dist[i - 1] > d; --i) dist[i] = dist[i - 1];
+        dist[i] = d;
+        count = std::min(count + 1, NOVELTY_K);
+    }
+};
+
+bool NoveltySearch::enabled() { return g_tunables.fitness_weight_novelty > 0.0f; }
+
+void NoveltySearch::clear() {
+    ticks = 0;
+    archive.clear();
+    dead.clear();
+    live_rows = 0;
+    tree_rows = 0;
+    main = Tree();
+    recent = Tree();
+    population.clear();
+    bots.clear();
+    population_tree = Tree();
+    scorings = 0;
+    offered = 0;
+    seconds = 0.0;
+    mean_novelty = 0.0f;
+}
+
+void NoveltySearch::Tree::build(const std::vector<float>& data, std::vector<int> rows) {
+    nodes.clear();
+    order = std::move(rows);
+    if (!order.empty()) build_node(data, 0, int(order.size()));
+    // Copied in tree order, so a leaf's rows are contiguous for the search
+    points.resize(order.size() * NOVELTY_DIMS);
+    for (size_t i = 0; i < order.size(); ++i) std::copy_n(data.begin() + size_t(order[i]) * NOVELTY_DIMS, NOVELTY_DIMS, points.begin() + i * NOVELTY_DIMS);
+}
+
+int NoveltySearch::Tree::build_node(const std::vector<float>& data, int begin, int end) {
+    const int index = int(nodes.size());
+    nodes.emplace_back();
+    nodes[index].begin = begin;
+    nodes[index].end = end;
+    if (end - begin <= LEAF_ROWS) return index;
+    std::array<float, NOVELTY_DIMS> low, high;
+    low.fill(std::numeric_limits<float>::infinity());
+    high.fill(-std::numeric_limits<float>::infinity());
+    for (int i = begin; i < end; ++i) {
+        const float* x = data.data() + size_t(order[i]) * NOVELTY_DIMS;
+        for (int k = 0; k < NOVELTY_DIMS; ++k) {
+            low[k] = std::min(low[k], x[k]);
+            high[k] = std::max(high[k], x[k]);
+        }
+    }
+    int dim = 0;
+    for (int k = 1; k < NOVELTY_DIMS; ++k) {
+        if (high[k] - low[k] > high[dim] - low[dim]) dim = k;
+    }
+    const float value = low[dim] + (high[dim] - low[dim]) * 0.5f;
+    if (!(value > low[dim])) return index; // all rows equal: a leaf, however many
+    // Both sides keep a row: the minimum goes left, the maximum right
+    const int split = int(std::partition(order.begin() + begin, order.begin() + end, [&](int row) {
+        return data[size_t(row) * NOVELTY_DIMS + dim] < value;
+    }) - order.begin());
+    nodes[index].dim = dim;
+    nodes[index].value = value;
+    const int left = build_node(data, begin, split);
+    const int right = build_node(data, split, end);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+void NoveltySearch::Tree::search(int index, const uint8_t* dead, int self, const float* query, Neighbours& best) const {
+    const Node& node = nodes[index];
+    if (node.dim < 0) {
+        for (int i = node.begin; i < node.end; ++i) {
+            const int row = order[i];
+            if (row != self && !(dead && dead[row])) best.offer(squared_distance(query, points.data() + size_t(i) * NOVELTY_DIMS));
+        }
+        return;
+    }
+    // Every row on the far side is at least |diff| away along dim
+    const float diff = query[node.dim] - node.value;
+    const int near = diff < 0.0f ? node.left : node.right;
+    const int far = diff < 0.0f ? node.right : node.left;
+    search(near, dead, self, query, best);
+    if (diff * diff < best.worst()) search(far, dead, self, query, best);
+}
+
+void NoveltySearch::add_row(const BehaviorDescriptor& descriptor) {
+    archive.insert(archive.end(), descriptor.begin(), descriptor.end());
+    dead.push_back(0);
+    ++live_rows;
+}
+
+void NoveltySearch::rebuild_archive_tree() {
+    // Drop the replaced rows, then index everything in main
+    size_t kept = 0;
+    for (size_t row = 0; row < dead.size(); ++row) {
+        if (dead[row]) continue;
+        if (kept != row) std::copy_n(archive.begin() + row * NOVELTY_DIMS, NOVELTY_DIMS, archive.begin() + kept * NOVELTY_DIMS);
+        ++kept;
+    }
+    archive.resize(kept * NOVELTY_DIMS);
+    dead.assign(kept, 0);
+    tree_rows = kept;
+    std::vector<int> rows(kept);
+    std::iota(rows.begin(), rows.end(), 0);
+    main.build(archive, std::move(rows));
+    recent = Tree();
+}
+
+void NoveltySearch::record(const Game& game, const Player& p) {
+    if (sim_rand_float() >= NOVELTY_ARCHIVE_CHANCE) return;
+    ++offered;
+    // Reservoir sampling: once full, the archive stays a uniform sample of every descriptor offered
+    if (live_rows >= size_t(NOVELTY_ARCHIVE_SIZE)) {
+        if (double(sim_rand_float()) * double(offered) >= double(NOVELTY_ARCHIVE_SIZE)) return;
+        int victim;
+        do victim = sim_rand() % int(dead.size()); while (dead[victim]);
+        dead[victim] = 1;
+        --live_rows;
+    }
+    add_row(behavior_descriptor(p, game.width, game.height));
+}
+
+void NoveltySearch::knn(const float* query, int self, Neighbours& best) const {
+    if (!main.nodes.empty()) main.search(0, dead.data(), -1, query, best);
+    if (!recent.nodes.empty()) recent.search(0, dead.data(), -1, query, best);
+    if (!population_tree.nodes.empty()) population_tree.search(0, nullptr, self, query, best);
+}
+
+void NoveltySearch::on_tick(Game& game) {
+    if (!enabled()) return;
+    if (++ticks < NOVELTY_INTERVAL) return;
+    ticks = 0;
+    score(game);
+}
+
+void NoveltySearch::score(Game& game) {
+    const auto start = std::chrono::steady_clock::now();
+    // The rows added since main was built: merged into it once they are many, else indexed alone
+    const size_t recent_rows = dead.size() - tree_rows;
+    if (recent_rows > std::max(MIN_RECENT, live_rows / RECENT_FRACTION)) {
+        rebuild_archive_tree();
+    } else if (recent_rows != recent.order.size()) {
+        std::vector<int> rows(recent_rows);
+        std::iota(rows.begin(), rows.end(), int(tree_rows));
+        recent.build(archive, std::move(rows));
+    }
+    bots.clear();
+    population.clear();
+    for (Player* p : game.players) {
+        if (!p->alive || p->is_hunter || p->is_human) continue;
+        bots.push_back(p);
+        const BehaviorDescriptor d = behavior_descriptor(*p, game.width, game.height);
+        population.insert(population.end(), d.begin(), d.end());
+    }
+    std::vector<int> rows(bots.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    population_tree.build(population, std::move(rows));
+    // Each query writes only its own bot's score
+    ThreadPool::shared().parallel_for(bots.size(), QUERY_WORK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Neighbours best;
+            knn(population.data() + i * NOVELTY_DIMS, int(i), best);
+            float sum = 0.0f;
+            for (int k = 0; k < best.count; ++k) sum += std::sqrt(best.dist[k]);
+            bots[i]->novelty = best.count > 0 ? sum / float(best.count) : 0.0f;
+        }
+    });
+    float total = 0.0f;
+    for (Player* p : bots) total += p->novelty;
+    mean_novelty = bots.empty() ? 0.0f : total / float(bots.size());
+    ++scorings;
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
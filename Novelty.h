@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Settings.h"
+class Game;
+class Player;
+
+// Behavioural descriptor of a bot: where it spent its life (share of its visited cells in each
+// of the GRID x GRID world regions), how straight it explored (new cells per cell-width moved),
+// its average speed and its kill/(kill + food) ratio. Every component lies in [0, 1].
+constexpr int NOVELTY_FOOTPRINT_CELLS = NOVELTY_FOOTPRINT_GRID * NOVELTY_FOOTPRINT_GRID;
+constexpr int NOVELTY_DIMS = NOVELTY_FOOTPRINT_CELLS + 3;
+using BehaviorDescriptor = std::array<float, NOVELTY_DIMS>;
+BehaviorDescriptor behavior_descriptor(const Player& p, int world_width, int world_height);
+
+// Novelty search (FITNESS_WEIGHT_NOVELTY > 0): a bot's novelty is the mean euclidean distance
+// from its descriptor to the NOVELTY_K nearest among the archive and the other alive bots, and
+// Game::calc_fitness adds fitness_weight_novelty times it.
+// Nothing runs per tick. Every NOVELTY_INTERVAL ticks score() describes the alive bots and runs
+// all their k-nearest queries on the thread pool; a dying bot's descriptor is archived with
+// NOVELTY_ARCHIVE_CHANCE. The archive is searched through two kd-trees: one over most of it,
+// rebuilt once the rows added since pass 1/8 of it, and a small one over those recent rows,
+// rebuilt every scoring. Past NOVELTY_ARCHIVE_SIZE each new descriptor replaces a random one
+// with the probability that keeps the archive a uniform sample of all descriptors offered.
+class NoveltySearch {
+public:
+    static bool enabled();
+    // Called every tick from maintain_population; scores the alive bots every NOVELTY_INTERVAL calls
+    void on_tick(Game& game);
+    // Scores every alive bot now
+    void score(Game& game);
+    // Offers a dying bot's descriptor to the archive
+    void record(const Game& game, const Player& p);
+    void clear();
+
+    size_t archived() const { return live_rows; }
+    long long scorings = 0;
+    long long offered = 0;      // descriptors that passed NOVELTY_ARCHIVE_CHANCE
+    double seconds = 0.0;       // spent scoring
+    float mean_novelty = 0.0f;  // of the bots in the last scoring
+
+private:
+    struct Neighbours;
+    // Static kd-tree over some rows of a descriptor matrix. A node splits its rows at the middle
+    // of their widest dimension, not at the median: most footprint components are 0, and a
+    // median split would leave rows tied at 0 on both sides, where no query can skip either.
+    struct Tree {
+        struct Node {
+            int dim = -1;            // -1 = leaf
+            float value = 0.0f;      // rows below value go left
+            int left = -1, right = -1;
+            int begin = 0, end = 0;  // leaf: its rows in order
+        };
+        std::vector<Node> nodes;     // nodes[0] is the root
+        std::vector<int> order;      // rows of the matrix, leaves' rows contiguous
+        std::vector<float> points;   // their descriptors, in the same order
+        void build(const std::vector<float>& data, std::vector<int> rows);
+        int build_node(const std::vector<float>& data, int begin, int end);
+        // Offers best every row under node that may be among its nearest; rows marked in dead
+        // (if given) and the row self are skipped
+        void search(int node, const uint8_t* dead, int self, const float* query, Neighbours& best) const;
+    };
+    // The nearest to query in the archive and the population, without population row self
+    void knn(const float* query, int self, Neighbours& best) const;
+    void add_row(const BehaviorDescriptor& descriptor);
+    void rebuild_archive_tree();
+
+    int ticks = 0;
+    std::vector<float> archive;     // rows x NOVELTY_DIMS
+    std::vector<uint8_t> dead;      // replaced rows, dropped at the next rebuild
+    size_t live_rows = 0;
+    size_t tree_rows = 0;           // rows covered by main; the rest are recent
+    Tree main, recent;
+    std::vector<float> population;  // the alive bots of the current scoring
+    std::vector<Player*> bots;
+    Tree population_tree;
+};
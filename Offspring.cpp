@@ -0,0 +1,101 @@
+#include "Offspring.h"
+#include "Game.h"
+#include "Player.h"
+#include "Random.h"
+#include "SparseNet.h"
+#include "ThreadPool.h"
+#include "Tunables.h"
+#include <algorithm>
+#include <tuple>
+
+namespace {
+    constexpr int TOURNAMENT_SIZE = 5;
+    constexpr double GENOME_WORK = 8.0 * NN_WEIGHT_COUNT; // float ops (and draws) of one build_genome
+
+    SDL_Color random_color() {
+        return {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
+    }
+}
+
+OffspringBatch::Plan OffspringBatch::plan_child(const Game& game, const std::vector<Elite>& elites, bool have_alive) {
+    Plan plan;
+    if (!Player::hall_of_fame.empty() && (sim_rand() % 100 < 5)) {
+        // 5% chance: insert Hall of Fame agent
+        plan.kind = Kind::HallOfFame;
+        plan.first = sim_rand() % Player::hall_of_fame.size();
+    } else if ((sim_rand() % 100 < 30) || !have_alive) {
+        plan.kind = Kind::Random;
+    } else if (!elites.empty() && (sim_rand() % 100 < 40)) {
+        // 40% chance: clone an elite
+        plan.kind = Kind::EliteClone;
+        plan.first = sim_rand() % elites.size();
+        plan.parent_id = elites[plan.first].parent_id;
+    } else if (sampler.size() >= 2) {
+        // Otherwise crossover of two gene pool entries (TOURNAMENT_SIZE for tournaments)
+        auto [first, second] = sampler.parents(g_selection, TOURNAMENT_SIZE);
+        plan.kind = Kind::Crossover;
+        plan.first = first;
+        plan.second = second;
+    }
+    plan.color = random_color();
+    plan.x = static_cast<float>(sim_rand() % game.width);
+    plan.y = static_cast<float>(sim_rand() % game.height);
+    plan.seed = static_cast<unsigned int>(sim_rand());
+    return plan;
+}
+
+void OffspringBatch::build_genome(const std::vector<Elite>& elites, const Plan& plan, size_t slot) {
+    ScopedSimSeed seeded(plan.seed);
+    auto& g = genes[slot];
+    auto& b = biases[slot];
+    switch (plan.kind) {
+        case Kind::HallOfFame:
+            g = Player::hall_of_fame[plan.first].genes;
+            b = Player::hall_of_fame[plan.first].biases;
+            break;
+        case Kind::EliteClone:
+            g = elites[plan.first].genes;
+            b = elites[plan.first].biases;
+            break;
+        case Kind::Crossover: {
+            const auto& parent1 = Player::gene_pool[plan.first];
+            const auto& parent2 = Player::gene_pool[plan.second];
+            g = crossover(parent1.genes, parent2.genes);
+            b = crossover_biases(parent1.biases, parent2.biases);
+            int nMutate = int(g_tunables.mutation_attempts * Player::adaptive_mutation_rate);
+            mutate_genes(g, nMutate);
+            mutate_biases(b, nMutate);
+            if (SPARSE_PRUNE_RATE > 0.0f) prune_genes(g, SPARSE_PRUNE_RATE);
+            break;
+        }
+        case Kind::Random:
+            std::tie(g, b) = random_genes_and_biases();
+            break;
+    }
+}
+
+void OffspringBatch::spawn(Game& game, int count, const std::vector<Elite>& elites, bool have_alive) {
+    std::fill(std::begin(spawned), std::end(spawned), 0);
+    if (count <= 0) return;
+    sampler.sync(Player::gene_pool, Player::gene_pool_version);
+    plans.clear();
+    for (int i = 0; i < count; ++i) {
+        plans.push_back(plan_child(game, elites, have_alive));
+        have_alive = true; // the children planned so far count as alive
+    }
+    if (genes.size() < plans.size()) {
+        genes.resize(plans.size());
+        biases.resize(plans.size());
+    }
+    // The gene pool, hall of fame and elites are only read until the spawn pass
+    ThreadPool::shared().parallel_for(size_t(count), GENOME_WORK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) build_genome(elites, plans[i], i);
+    });
+    for (int i = 0; i < count; ++i) {
+        const Plan& plan = plans[i];
+        Player* child = new Player(genes[i], biases[i], DOT_WIDTH, DOT_HEIGHT, plan.color, plan.x, plan.y, plan.parent_id);
+        if (SPARSE_INFERENCE && plan.kind == Kind::HallOfFame) child->compile_sparse_network();
+        game.add_player(child);
+        ++spawned[static_cast<int>(plan.kind)];
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Selection.h"
+class Game;
+
+// Refills the population in maintain_population with a batch of children at once:
+//   1. plan:   on the calling thread, draw every child's kind (hall of fame, random, elite
+//              clone or crossover), parents (by g_selection), colour, position and a genome seed
+//   2. build:  produce the genomes on the thread pool (ThreadPool.h) into per-child buffers
+//              kept between calls; each child reseeds its thread's generator (ScopedSimSeed),
+//              so the genomes do not depend on the thread count
+//   3. spawn:  construct the Players and append them to game.players in plan order
+// Only the plan pass draws on the caller's generator, so a seeded run stays reproducible.
+class OffspringBatch {
+public:
+    // A reproducing elite, copied out of the Player so it outlives the agent
+    struct Elite {
+        std::vector<std::vector<float>> genes, biases;
+        int parent_id = -1;
+    };
+    // Spawns count children. have_alive: there was an alive bot to breed from before the batch
+    void spawn(Game& game, int count, const std::vector<Elite>& elites, bool have_alive);
+    // In the last spawn: children per kind, indexed by Kind
+    int spawned[4] = {};
+
+    enum class Kind { Random, HallOfFame, EliteClone, Crossover };
+
+private:
+    struct Plan {
+        Kind kind = Kind::Random;
+        int first = -1, second = -1; // hall of fame entry, elite, or the gene pool parents
+        unsigned int seed = 0;
+        SDL_Color color;
+        float x = 0.0f, y = 0.0f;
+        int parent_id = -1;
+    };
+    Plan plan_child(const Game& game, const std::vector<Elite>& elites, bool have_alive);
+    void build_genome(const std::vector<Elite>& elites, const Plan& plan, size_t slot);
+
+    std::vector<Plan> plans;
+    std::vector<std::vector<std::vector<float>>> genes, biases; // per child slot
+    ParentSampler sampler; // over Player::gene_pool, synced once per spawn
+};
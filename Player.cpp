@@ -10,11 +10,23 @@
 #include <sstream>
 #include <iostream>
 #include "Settings.h"
+#include "Random.h"
+#include "Tunables.h"
+#include "Profiler.h"
+#include "Sensing.h"
+#include "FastMath.h"
+#include "QuantizedNet.h"
+#include "SparseNet.h"
+#include "ThreadPool.h"
+#include "GenomeIndex.h"
 #include <vector>
 #include <SDL.h>
-#include <omp.h> // Enable OpenMP parallelization
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <queue>
 
-extern int game_time_units;
+extern thread_local int game_time_units;
 class Food;
 class Player;
 
@@ -22,6 +34,77 @@ namespace {
     float leaky_relu(float x) { return x > 0.0f ? x : 0.01f * x; }
     float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
     int toWASD(float v) { return v > 0.5f ? 1 : 0; }
+
+    constexpr double GENETIC_DISTANCE_WORK = 3.0 * NN_WEIGHT_COUNT; // float ops of one genetic_distance
+    constexpr double GENOME_QUERY_WORK = 32.0 * GENETIC_DISTANCE_WORK; // a GenomeIndex query evaluates a few dozen distances
+
+    // Calls row(i) for every i in [0, n) on the thread pool. Row i is expected to cost n - i - 1;
+    // rows are handed out in pairs (k, n - 1 - k) so every piece of the loop costs the same.
+    template <typename Row>
+    void for_each_triangle_row(size_t n, Row&& row) {
+        ThreadPool::shared().parallel_for((n + 1) / 2, GENETIC_DISTANCE_WORK * n, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                row(k);
+                if (n - 1 - k != k) row(n - 1 - k);
+            }
+        });
+    }
+
+    // Mean genetic distance over all pairs of entries. The rows are summed in order, so the
+    // result does not depend on the thread count.
+    float mean_pairwise_distance(const std::vector<Player::GeneEntry>& entries) {
+        const size_t n = entries.size();
+        if (n < 2) return 0.0f;
+        std::vector<float> row_sum(n, 0.0f);
+        for_each_triangle_row(n, [&](size_t i) {
+            float sum = 0.0f;
+            for (size_t j = i + 1; j < n; ++j) sum += Player::genetic_distance(entries[i], entries[j]);
+            row_sum[i] = sum;
+        });
+        float sum = 0.0f;
+        for (float s : row_sum) sum += s;
+        return sum / float(n * (n - 1) / 2);
+    }
+
+    constexpr double FORMAT_WORK = 100.0 * NN_WEIGHT_COUNT; // float ops worth of formatting one entry as text
+
+    // Writes the FITNESS ... END blocks of the entries. Each block is formatted on the thread
+    // pool, then the blocks are written in order.
+    void write_gene_entries(std::ofstream& ofs, const std::vector<Player::GeneEntry>& entries) {
+        std::vector<std::string> blocks(entries.size());
+        ThreadPool::shared().parallel_for(entries.size(), FORMAT_WORK, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Player::GeneEntry& entry = entries[i];
+                std::ostringstream out;
+                out << "FITNESS " << entry.fitness << "\n";
+                out << "GENES\n";
+                for (const auto& layer : entry.genes) {
+                    for (float w : layer) out << w << ' ';
+                    out << '\n';
+                }
+                out << "BIASES\n";
+                for (const auto& bias : entry.biases) {
+                    for (float b : bias) out << b << ' ';
+                    out << '\n';
+                }
+                out << "END\n";
+                blocks[i] = out.str();
+            }
+        });
+        for (const auto& block : blocks) ofs << block;
+    }
+}
+
+namespace {
+    std::atomic<uint32_t> player_uids{0};
+}
+
+uint32_t Player::next_uid() {
+    return player_uids.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void Player::reset_uids() {
+    player_uids.store(0, std::memory_order_relaxed);
 }
 
 Player::Player(int width, int height, SDL_Color color, float x, float y, bool alive)
@@ -35,16 +118,14 @@ Player::Player(int width, int height, SDL_Color color, float x, float y, bool al
         std::vector<float> layer(in * out);
         std::vector<float> bias(out);
         float a = std::sqrt(6.0f / (in + out));
-        std::generate(layer.begin(), layer.end(), [&]() { return ((float)rand() / RAND_MAX * 2 - 1) * a; });
+        std::generate(layer.begin(), layer.end(), [&]() { return ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * a; });
         std::fill(bias.begin(), bias.end(), 0.0f);
         genes.push_back(layer);
         biases.push_back(bias);
     }
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * M_PI);
-    angle = angle_dist(gen);
+    angle = sim_rand_float() * 2.0f * float(M_PI);
     speed = MAX_SPEED;
+    quantize_network();
 }
 
 Player::Player(const std::vector<std::vector<float>>& parent_genes, int width, int height, SDL_Color color, float x, float y, int parent_id)
@@ -55,21 +136,17 @@ Player::Player(const std::vector<std::vector<float>>& parent_genes, int width, i
         biases[l].resize(genes[l].size() / (l == genes.size() - 1 ? NN_H3 : (l == 0 ? NN_INPUTS : (l == 1 ? NN_H1 : NN_H2))));
         std::fill(biases[l].begin(), biases[l].end(), 0.0f);
     }
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * M_PI);
-    angle = angle_dist(gen);
+    angle = sim_rand_float() * 2.0f * float(M_PI);
     speed = MAX_SPEED;
+    quantize_network();
 }
 
 Player::Player(const std::vector<std::vector<float>>& parent_genes, const std::vector<std::vector<float>>& parent_biases, int width, int height, SDL_Color color, float x, float y, int parent_id)
     : genes(parent_genes), biases(parent_biases), width(width), height(height), color(color), x(x), y(y), alive(true), foodCount(0), lifeTime(0), killTime(0), foodScore(0), playerEaten(0), parent_id(parent_id), totalFoodEaten(0), totalPlayersEaten(0)
 {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * M_PI);
-    angle = angle_dist(gen);
+    angle = sim_rand_float() * 2.0f * float(M_PI);
     speed = MAX_SPEED;
+    quantize_network();
 }
 
 void Player::initialize_weights_xavier() {
@@ -82,37 +159,58 @@ void Player::initialize_weights_xavier() {
         std::vector<float> layer(in * out);
         std::vector<float> bias(out);
         float a = std::sqrt(6.0f / (in + out));
-        std::generate(layer.begin(), layer.end(), [&]() { return ((float)rand() / RAND_MAX * 2 - 1) * a; });
+        std::generate(layer.begin(), layer.end(), [&]() { return ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * a; });
         std::fill(bias.begin(), bias.end(), 0.0f);
         genes.push_back(layer);
         biases.push_back(bias);
     }
+    quantize_network();
 }
 
-std::array<float, NN_OUTPUTS> Player::predict(const std::array<float, NN_INPUTS>& input) {
-    std::vector<float> output(input.begin(), input.end());
-    std::vector<int> layer_sizes = {NN_INPUTS, NN_H1, NN_H2, NN_H3, NN_OUTPUTS};
-    for (size_t l = 0; l < genes.size(); ++l) {
-        std::vector<float> next(layer_sizes[l+1], 0.0f);
-        for (int j = 0; j < layer_sizes[l+1]; ++j) {
-            for (int i = 0; i < layer_sizes[l]; ++i) {
-                next[j] += output[i] * genes[l][i * layer_sizes[l+1] + j];
-            }
-            next[j] += biases[l][j];
-            if (l < genes.size() - 1) next[j] = leaky_relu(next[j]);
-            else {
-                // Last layer: tanh for angle, sigmoid for speed
-                if (j == 0) next[j] = std::tanh(next[j]); // angle
-                else next[j] = sigmoid(next[j]); // speed
+void Player::quantize_network() {
+    qnet = QuantizedNet(genes, biases, g_inference_mode);
+}
+
+void Player::compile_sparse_network() {
+    auto net = std::make_unique<SparseNet>(genes, biases, SPARSE_WEIGHT_THRESHOLD);
+    if (!net->empty()) sparse_net = std::move(net);
+}
+
+std::array<float, NN_OUTPUTS> Player::forward(const std::array<float, NN_INPUTS>& input) const {
+    std::array<float, NN_OUTPUTS> raw;
+    if (!qnet.empty()) {
+        raw = qnet.forward(input);
+    } else if (sparse_net) {
+        raw = sparse_net->forward(input);
+    } else {
+        std::vector<float> output(input.begin(), input.end());
+        std::vector<int> layer_sizes = {NN_INPUTS, NN_H1, NN_H2, NN_H3, NN_OUTPUTS};
+        for (size_t l = 0; l < genes.size(); ++l) {
+            std::vector<float> next(layer_sizes[l+1], 0.0f);
+            for (int j = 0; j < layer_sizes[l+1]; ++j) {
+                for (int i = 0; i < layer_sizes[l]; ++i) {
+                    next[j] += output[i] * genes[l][i * layer_sizes[l+1] + j];
+                }
+                next[j] += biases[l][j];
+                if (l < genes.size() - 1) next[j] = leaky_relu(next[j]);
             }
+            output = next;
         }
-        output = next;
+        std::copy(output.begin(), output.begin() + NN_OUTPUTS, raw.begin());
     }
+    // Last layer: tanh for angle, sigmoid for speed
+    std::array<float, NN_OUTPUTS> output;
+    for (int j = 0; j < NN_OUTPUTS; ++j) output[j] = j == 0 ? sim_tanh(raw[j]) : sigmoid(raw[j]);
+    return output;
+}
+
+std::array<float, NN_OUTPUTS> Player::predict(const std::array<float, NN_INPUTS>& input) {
+    std::array<float, NN_OUTPUTS> output = forward(input);
     // Output[0]: desired angle in [-1,1] -> [0, 2pi] (absolute)
     // Output[1]: speed in [0, MAX_SPEED]
     std::array<float, NN_OUTPUTS> result{};
     // Add small random noise to angle for sensitivity
-    float angle_noise = (((float)rand() / RAND_MAX) - 0.5f) * 0.2f; // noise in [-0.1, 0.1] radians
+    float angle_noise = (((float)sim_rand() / SIM_RAND_MAX) - 0.5f) * 0.2f; // noise in [-0.1, 0.1] radians
     result[0] = (output[0] + 1.0f) * M_PI + angle_noise; // [-1,1] -> [0,2pi] + noise
     result[1] = output[1] * MAX_SPEED;
     return result;
@@ -122,9 +220,10 @@ std::pair<std::vector<std::vector<float>>, std::vector<std::vector<float>>> Play
     std::vector<std::vector<float>> new_genes = genes;
     std::vector<std::vector<float>> new_biases = biases;
     if (mutate) {
-        int nMutate = int(MUTATION_ATTEMPTS * Player::adaptive_mutation_rate);
+        int nMutate = int(g_tunables.mutation_attempts * Player::adaptive_mutation_rate);
         mutate_genes(new_genes, nMutate);
         mutate_biases(new_biases, nMutate);
+        if (SPARSE_PRUNE_RATE > 0.0f) prune_genes(new_genes, SPARSE_PRUNE_RATE);
     }
     return {new_genes, new_biases};
 }
@@ -143,6 +242,9 @@ bool Player::collide(const Player& other) const {
 int Player::food_to_size[MAX_FOOD + 1];
 int Player::size_to_food[MAX_PLAYER_SIZE + 1];
 bool Player::lookup_tables_initialized = false;
+float Player::speed_factor_by_size[MAX_PLAYER_SIZE + 1];
+double Player::hunger_pow_by_size[MAX_PLAYER_SIZE + 1];
+float Player::hunger_pow_exponent = 0.0f;
 
 void Player::init_lookup_tables() {
     // Fill food_to_size
@@ -159,9 +261,27 @@ void Player::init_lookup_tables() {
             }
         }
     }
+    // Sizes from 1, so the speed factor's division is defined
+    for (int s = 1; s <= MAX_PLAYER_SIZE; ++s) {
+        speed_factor_by_size[s] = std::pow(float(DOT_WIDTH) / float(s), PLAYER_SIZE_SPEED_EXPONENT);
+        hunger_pow_by_size[s] = std::pow(s, g_tunables.hunger_exponent);
+    }
+    hunger_pow_exponent = g_tunables.hunger_exponent;
     lookup_tables_initialized = true;
 }
 
+float Player::size_speed_factor(int size) {
+    if (!lookup_tables_initialized) init_lookup_tables();
+    if (size < 1 || size > MAX_PLAYER_SIZE) return std::pow(float(DOT_WIDTH) / float(size), PLAYER_SIZE_SPEED_EXPONENT);
+    return speed_factor_by_size[size];
+}
+
+double Player::hunger_size_pow(int size, float exponent) {
+    if (!lookup_tables_initialized) init_lookup_tables();
+    if (size < 1 || size > MAX_PLAYER_SIZE || exponent != hunger_pow_exponent) return std::pow(size, exponent);
+    return hunger_pow_by_size[size];
+}
+
 void Player::update_size_from_food() {
     if (!lookup_tables_initialized) init_lookup_tables();
     int fc = std::max(0, std::min(foodCount, MAX_FOOD));
@@ -191,7 +311,8 @@ bool Player::eatPlayer(Game& game, Player& other) {
         if (other.foodCount == 0) foodCount += EATEN_ADD;
         else foodCount += other.foodCount * EATEN_FACTOR + EATEN_ADD;
         update_size_from_food();
-        other.alive = false;
+        game.kill_player(other);
+        game.food_changed(*this);
         return true;
     }
     return false;
@@ -212,12 +333,9 @@ bool Player::eatFood(Game& game) {
             totalFoodEaten++;
             killTime = 0;
             update_size_from_food();
-            auto it = std::find(game.foods.begin(), game.foods.end(), food);
-            if (it != game.foods.end()) {
-                delete food;
-                game.foods.erase(it);
-                game.randomFood(1);
-            }
+            game.food_changed(*this);
+            game.remove_food(food);
+            game.randomFood(1);
             return true;
         }
     }
@@ -227,120 +345,30 @@ bool Player::eatFood(Game& game) {
 NNInputsResult Player::get_nn_inputs(const Game& game) {
     // 0-1: Distance and direction to nearest food
     float min_food_dist = 1e6f, food_dx = 0, food_dy = 0;
-    for (auto* food : game.foods) {
-        float dx = food->x - x;
-        float dy = food->y - y;
-        float dist = std::sqrt(dx*dx + dy*dy);
-        if (dist < min_food_dist) {
-            min_food_dist = dist;
-            food_dx = dx;
-            food_dy = dy;
-        }
+    if (const Food* food = game.nearest_food(x, y, min_food_dist)) {
+        food_dx = food->x - x;
+        food_dy = food->y - y;
     }
-    float diag = std::sqrt(game.width*game.width + game.height*game.height);
-    float food_dist_scaled = min_food_dist / diag; // [0, 1]
-    food_dist_scaled = food_dist_scaled * 2.0f - 1.0f; // [-1, 1]
-    float to_food_angle = std::atan2(food_dy, food_dx);
-    float rel_food_angle = to_food_angle - angle;
-    while (rel_food_angle < -M_PI) rel_food_angle += 2*M_PI;
-    while (rel_food_angle > M_PI) rel_food_angle -= 2*M_PI;
-    float rel_food_angle_scaled = rel_food_angle / M_PI; // [-1, 1]
-
-    // 2: Distance and relative angle to nearest player (not self)
+    // 2-3: Edge distance and direction to nearest player (not self)
     float min_player_dist = 1e6f, player_dx = 0, player_dy = 0;
     int nearest_player_width = DOT_WIDTH;
-    for (auto* p : game.players) {
-        if (p == this || !p->alive) continue;
-        float dx = p->x - x;
-        float dy = p->y - y;
-        float center_dist = std::sqrt(dx*dx + dy*dy);
-        float r_self = (width + height) / 4.0f;
-        float r_other = (p->width + p->height) / 4.0f;
-        float edge_dist = center_dist - r_self - r_other;
-        if (edge_dist < min_player_dist) {
-            min_player_dist = edge_dist;
-            player_dx = dx;
-            player_dy = dy;
-            nearest_player_width = p->width;
-        }
-    }
-    float player_dist_scaled = min_player_dist / diag; // [0, 1]
-    player_dist_scaled = player_dist_scaled * 2.0f - 1.0f; // [-1, 1]
-    float to_player_angle = std::atan2(player_dy, player_dx);
-    float rel_player_angle = to_player_angle - angle;
-    while (rel_player_angle < -M_PI) rel_player_angle += 2*M_PI;
-    while (rel_player_angle > M_PI) rel_player_angle -= 2*M_PI;
-    float rel_player_angle_scaled = rel_player_angle / M_PI; // [-1, 1]
-
-    // 8: Own size (normalized to default size)
-    float size_norm = float(width) / float(DOT_WIDTH); // 1.0 = default size
-    size_norm = std::max(-1.0f, std::min(1.0f, (size_norm - 1.0f) / (float(MAX_PLAYER_SIZE)/float(DOT_WIDTH) - 1.0f) * 2.0f - 1.0f));
-    // 9: Own food count (normalized, clipped after 50)
-    float food_count_norm = std::min(1.0f, float(foodCount) / 50.0f);
-    food_count_norm = food_count_norm * 2.0f - 1.0f;
-    // 10: Own normalized size (relative to max size)
-    float own_norm_size = float(width) / float(MAX_PLAYER_SIZE); // [0,1]
-    own_norm_size = own_norm_size * 2.0f - 1.0f;
-    // 11: Own food count (again, for new input)
-    float own_food_count = food_count_norm;
-    // 10-13: Wall distances (left, right, top, bottom, normalized)
-    float left_wall = float(x) / game.width;
-    left_wall = left_wall * 2.0f - 1.0f;
-    float right_wall = float(game.width - (x + width)) / game.width;
-    right_wall = right_wall * 2.0f - 1.0f;
-    float top_wall = float(y) / game.height;
-    top_wall = top_wall * 2.0f - 1.0f;
-    float bottom_wall = float(game.height - (y + height)) / game.height;
-    bottom_wall = bottom_wall * 2.0f - 1.0f;
-
-    float speed_scaled = speed / MAX_SPEED;
-    speed_scaled = speed_scaled * 2.0f - 1.0f;
-    // New input: size difference to nearest player (normalized)
-    float size_diff = float(width - nearest_player_width) / float(DOT_WIDTH); // positive: bigger, negative: smaller
-    size_diff = std::max(-1.0f, std::min(1.0f, size_diff));
-
-    // Multiply all inputs by scale factor after normalization/scaling
-    food_dist_scaled *= SCALE_FOOD_DIST;
-    rel_food_angle_scaled *= SCALE_FOOD_ANGLE;
-    player_dist_scaled *= SCALE_PLAYER_DIST;
-    rel_player_angle_scaled *= SCALE_PLAYER_ANGLE;
-    left_wall *= SCALE_WALL;
-    right_wall *= SCALE_WALL;
-    top_wall *= SCALE_WALL;
-    bottom_wall *= SCALE_WALL;
-    speed_scaled *= SCALE_SPEED;
-    size_diff *= SCALE_SIZE_DIFF;
-    own_norm_size *= SCALE_OWN_SIZE;
-    own_food_count *= SCALE_OWN_FOOD;
-
-    // Temporal smoothing (low-pass filter)
-    // Used to decrease the effect of rapid changes in inputs to the outputs
-    // Can be adjusted by alpha
-    float alpha = NN_INPUT_SMOOTHING_ALPHA;
-    this->smoothed_food_dist = alpha * food_dist_scaled + (1 - alpha) * this->smoothed_food_dist;
-    this->smoothed_food_angle = alpha * rel_food_angle_scaled + (1 - alpha) * this->smoothed_food_angle;
-    this->smoothed_player_dist = alpha * player_dist_scaled + (1 - alpha) * this->smoothed_player_dist;
-    this->smoothed_player_angle = alpha * rel_player_angle_scaled + (1 - alpha) * this->smoothed_player_angle;
-    this->smoothed_left_wall = alpha * left_wall + (1 - alpha) * this->smoothed_left_wall;
-    this->smoothed_right_wall = alpha * right_wall + (1 - alpha) * this->smoothed_right_wall;
-    this->smoothed_top_wall = alpha * top_wall + (1 - alpha) * this->smoothed_top_wall;
-    this->smoothed_bottom_wall = alpha * bottom_wall + (1 - alpha) * this->smoothed_bottom_wall;
-    this->smoothed_speed = alpha * speed_scaled + (1 - alpha) * this->smoothed_speed;
-    this->smoothed_size_diff = alpha * size_diff + (1 - alpha) * this->smoothed_size_diff;
-    // Add smoothing for new inputs
-    this->smoothed_own_norm_size = alpha * own_norm_size + (1 - alpha) * this->smoothed_own_norm_size;
-    this->smoothed_own_food_count = alpha * own_food_count + (1 - alpha) * this->smoothed_own_food_count;
-    std::array<float, NN_INPUTS> inputs = {
-        this->smoothed_food_dist, this->smoothed_food_angle,
-        this->smoothed_player_dist, this->smoothed_player_angle,
-        this->smoothed_left_wall, this->smoothed_right_wall, this->smoothed_top_wall, this->smoothed_bottom_wall,
-        this->smoothed_speed,
-        this->smoothed_size_diff,
-        this->smoothed_own_norm_size,
-        this->smoothed_own_food_count
-    };
+    if (const Player* p = game.nearest_player(*this, min_player_dist)) {
+        player_dx = p->x - x;
+        player_dy = p->y - y;
+        nearest_player_width = p->width;
+    }
+    // 4-11: walls, speed, size difference, own size and food count (see sensor_inputs)
+    const float to_food_angle = sim_atan2(food_dy, food_dx), to_player_angle = sim_atan2(player_dy, player_dx);
+    const float neighbour_width = float(nearest_player_width), own_width = float(width), own_height = float(height);
+    const float own_food_count = float(foodCount);
+    SensorRows rows{&min_food_dist, &to_food_angle, &min_player_dist, &to_player_angle, &neighbour_width,
+                    &x, &y, &own_width, &own_height, &angle, &speed, &own_food_count};
+    std::array<float, NN_INPUTS> raw;
+    sensor_inputs(rows, 1, float(game.width), float(game.height), raw.data());
+    // Temporal smoothing, to damp the effect of rapid input changes on the outputs
+    smooth_inputs(smoothed_inputs.data(), raw.data(), NN_INPUTS);
     NNInputsResult result;
-    result.inputs = inputs;
+    result.inputs = smoothed_inputs;
     result.food_dx = food_dx;
     result.food_dy = food_dy;
     result.player_dx = player_dx;
@@ -361,7 +389,7 @@ void Player::apply_nn_output(const std::array<float, NN_OUTPUTS>& nn_output) {
     while (angle < 0) angle += 2.0f * M_PI;
     while (angle >= 2.0f * M_PI) angle -= 2.0f * M_PI;
     // Slow down with size growth
-    float size_factor = std::pow(float(DOT_WIDTH) / float(width), PLAYER_SIZE_SPEED_EXPONENT);
+    float size_factor = size_speed_factor(width);
     float min_speed_factor = PLAYER_MIN_SPEED_FACTOR; // Minimum speed factor, now tunable
     size_factor = std::max(size_factor, min_speed_factor);
     float effective_max_speed = MAX_SPEED * size_factor;
@@ -383,25 +411,27 @@ void Player::update_exploration_cell(int cell_size, int world_width, int world_h
 
 void Player::update(Game& game) {
     lifeTime++;
+    if (SPARSE_INFERENCE && !sparse_net && lifeTime >= SPARSE_MIN_LIFETIME) compile_sparse_network();
     killTime++;
     update_exploration_cell(Game::CELL_SIZE, game.width, game.height);
-    if (killTime >= KILL_TIME) {
+    if (killTime >= g_tunables.kill_time) {
         killTime = 0;
         if (foodCount > 0) {
             // Improved, gentler hunger curve
-            float base = HUNGER_BASE;
-            float scale = HUNGER_SCALE;
-            float exponent = HUNGER_EXPONENT;
-            int food_loss = std::clamp(int(std::ceil(base + scale * std::pow(width, exponent))), HUNGER_MIN, HUNGER_MAX);
+            float base = g_tunables.hunger_base;
+            float scale = g_tunables.hunger_scale;
+            float exponent = g_tunables.hunger_exponent;
+            int food_loss = std::clamp(int(std::ceil(base + scale * hunger_size_pow(width, exponent))), g_tunables.hunger_min, g_tunables.hunger_max);
             for (int i = 0; i < food_loss && foodCount > 0; ++i) {
                 decrease_size_step();
             }
+            game.food_changed(*this);
         } else if (KILL) {
-            alive = false;
+            game.kill_player(*this);
         }
     }
     if (!alive) return;
-    if (MITOSIS > 0 && foodCount >= 2 && rand() % MITOSIS == 0) {
+    if (MITOSIS > 0 && foodCount >= 2 && sim_rand() % MITOSIS == 0) {
         int child_food = foodCount / 2;
         std::pair<std::vector<std::vector<float>>, std::vector<std::vector<float>>> child_genes = mitosis(true);
         Player* child1 = new Player(child_genes.first, child_genes.second, DOT_WIDTH + child_food * FOOD_APPEND, DOT_HEIGHT + child_food * FOOD_APPEND, color, x, y, parent_id);
@@ -410,35 +440,48 @@ void Player::update(Game& game) {
         child2->foodCount = child_food;
         child1->update_size_from_food();
         child2->update_size_from_food();
-        game.players.push_back(child1);
-        game.players.push_back(child2);
-        alive = false;
+        game.kill_player(*this);
+        game.add_player(child1);
+        game.add_player(child2);
         return;
     }
-    NNInputsResult nn_result = get_nn_inputs(game);
-    auto nn_output = predict(nn_result.inputs);
-    apply_nn_output(nn_output);
-    float old_x = x;
-    float old_y = y;
-    x += std::cos(angle) * speed;
-    y += std::sin(angle) * speed;
-    distance_traveled += std::sqrt((x - old_x) * (x - old_x) + (y - old_y) * (y - old_y));
-    clamp_to_screen(game);
-    eatFood(game);
-    auto nearby_players = game.get_nearby_players(x, y);
-    for (auto* other : nearby_players) {
-        if (other->alive && other != this) {
-            eatPlayer(game, *other);
-        }
+    NNInputsResult nn_result;
+    {
+        PROFILE_AGENT_SCOPE(Sensing);
+        // Agents sensed in this tick's batch already have their inputs
+        if (!game.sensors.take(*this, nn_result.inputs)) nn_result = get_nn_inputs(game);
+    }
+    // Isolated bots keep their steering between network runs, staggered by uid
+    bool full_rate = !game.lod.enabled() || !game.sensors.isolated(*this, game.lod.radius);
+    ++(full_rate ? game.lod.full : game.lod.reduced);
+    if (full_rate || (uint32_t(lifeTime) + uid) % uint32_t(game.lod.interval) == 0) {
+        PROFILE_AGENT_SCOPE(Inference);
+        auto nn_output = predict(nn_result.inputs);
+        apply_nn_output(nn_output);
+    }
+    {
+        PROFILE_AGENT_SCOPE(Movement);
+        float old_x = x;
+        float old_y = y;
+        float sin_angle, cos_angle;
+        sim_sincos(angle, sin_angle, cos_angle);
+        x += cos_angle * speed;
+        y += sin_angle * speed;
+        distance_traveled += std::sqrt((x - old_x) * (x - old_x) + (y - old_y) * (y - old_y));
+        clamp_to_screen(game);
+    }
+    {
+        PROFILE_AGENT_SCOPE(Eating);
+        eatFood(game); // other players are eaten in Game's collision phase
     }
     last_angle = angle;
     last_speed = speed;
-    float to_food_angle = std::atan2(last_nn_food_dy, last_nn_food_dx);
+    float to_food_angle = sim_atan2(last_nn_food_dy, last_nn_food_dx);
     float rel_food_angle = to_food_angle - angle;
     while (rel_food_angle < -M_PI) rel_food_angle += 2*M_PI;
     while (rel_food_angle > M_PI) rel_food_angle -= 2*M_PI;
     last_rel_food_angle = rel_food_angle;
-    float to_player_angle = std::atan2(last_nn_player_dy, last_nn_player_dx);
+    float to_player_angle = sim_atan2(last_nn_player_dy, last_nn_player_dx);
     float rel_player_angle = to_player_angle - angle;
     while (rel_player_angle < -M_PI) rel_player_angle += 2*M_PI;
     while (rel_player_angle > M_PI) rel_player_angle -= 2*M_PI;
@@ -450,46 +493,23 @@ void Player::update(Game& game) {
     }
 }
 
-void Player::draw(SDL_Renderer* renderer) {
-    SDL_Rect rect = {static_cast<int>(x - width / 2.0f), static_cast<int>(y - height / 2.0f), width, height};
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
-    SDL_RenderFillRect(renderer, &rect);
-    // Draw direction arrow (half as long, with arrowhead)
-    float cx = x;
-    float cy = y;
-    float len = (10.0f + 10.0f * (speed / MAX_SPEED)) * 0.5f;
-    float ex = cx + std::cos(angle) * len;
-    float ey = cy + std::sin(angle) * len;
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawLine(renderer, static_cast<int>(cx), static_cast<int>(cy), static_cast<int>(ex), static_cast<int>(ey));
-    // Arrowhead
-    float head_len = len * 0.5f;
-    float head_angle = 0.5f; // radians, ~28 degrees
-    float left_x = ex - std::cos(angle - head_angle) * head_len;
-    float left_y = ey - std::sin(angle - head_angle) * head_len;
-    float right_x = ex - std::cos(angle + head_angle) * head_len;
-    float right_y = ey - std::sin(angle + head_angle) * head_len;
-    SDL_RenderDrawLine(renderer, static_cast<int>(ex), static_cast<int>(ey), static_cast<int>(left_x), static_cast<int>(left_y));
-    SDL_RenderDrawLine(renderer, static_cast<int>(ex), static_cast<int>(ey), static_cast<int>(right_x), static_cast<int>(right_y));
-}
-
 // Improved crossover: uniform, single-point, and arithmetic crossover for more diversity
 std::vector<std::vector<float>> crossover(const std::vector<std::vector<float>>& g1, const std::vector<std::vector<float>>& g2) {
     std::vector<std::vector<float>> result = g1;
     for (size_t l = 0; l < g1.size(); ++l) {
         int size = g1[l].size();
-        int method = rand() % 3; // 0: uniform, 1: single-point, 2: arithmetic
+        int method = sim_rand() % 3; // 0: uniform, 1: single-point, 2: arithmetic
         if (method == 0) { // Uniform crossover
             for (int i = 0; i < size; ++i) {
-                result[l][i] = (rand() % 2 == 0) ? g1[l][i] : g2[l][i];
+                result[l][i] = (sim_rand() % 2 == 0) ? g1[l][i] : g2[l][i];
             }
         } else if (method == 1) { // Single-point crossover
-            int point = rand() % size;
+            int point = sim_rand() % size;
             for (int i = 0; i < size; ++i) {
                 result[l][i] = (i < point) ? g1[l][i] : g2[l][i];
             }
         } else { // Arithmetic crossover
-            float alpha = ((float)rand() / RAND_MAX);
+            float alpha = ((float)sim_rand() / SIM_RAND_MAX);
             for (int i = 0; i < size; ++i) {
                 result[l][i] = alpha * g1[l][i] + (1.0f - alpha) * g2[l][i];
             }
@@ -501,55 +521,88 @@ std::vector<std::vector<float>> crossover(const std::vector<std::vector<float>>&
 // Improved mutation: larger, rarer mutations and occasional full randomization
 void mutate_genes(std::vector<std::vector<float>>& genes, int nMutate) {
     for (int m = 0; m < nMutate; ++m) {
-        int l = rand() % genes.size();
-        int idx = rand() % genes[l].size();
-        float noise = ((float)rand() / RAND_MAX * 2 - 1) * MUTATION_MAGNITUDE;
+        int l = sim_rand() % genes.size();
+        int idx = sim_rand() % genes[l].size();
+        float noise = ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * g_tunables.mutation_magnitude;
         // Large mutation
-        if (((float)rand() / RAND_MAX) < LARGE_MUTATION_PROB) noise *= LARGE_MUTATION_SCALE;
+        if (((float)sim_rand() / SIM_RAND_MAX) < g_tunables.large_mutation_prob) noise *= g_tunables.large_mutation_scale;
         genes[l][idx] += noise;
         // 1% chance for full randomization
-        if (rand() % 100 == 0) genes[l][idx] = ((float)rand() / RAND_MAX * 2 - 1) * 0.5f;
+        if (sim_rand() % 100 == 0) genes[l][idx] = ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * 0.5f;
     }
 }
 
 void mutate_biases(std::vector<std::vector<float>>& biases, int nMutate) {
     for (int m = 0; m < nMutate; ++m) {
-        int l = rand() % biases.size();
-        int idx = rand() % biases[l].size();
-        float noise = ((float)rand() / RAND_MAX * 2 - 1) * MUTATION_MAGNITUDE;
-        if (((float)rand() / RAND_MAX) < LARGE_MUTATION_PROB) noise *= LARGE_MUTATION_SCALE;
+        int l = sim_rand() % biases.size();
+        int idx = sim_rand() % biases[l].size();
+        float noise = ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * g_tunables.mutation_magnitude;
+        if (((float)sim_rand() / SIM_RAND_MAX) < g_tunables.large_mutation_prob) noise *= g_tunables.large_mutation_scale;
         biases[l][idx] += noise;
-        if (rand() % 100 == 0) biases[l][idx] = ((float)rand() / RAND_MAX * 2 - 1) * 0.5f;
+        if (sim_rand() % 100 == 0) biases[l][idx] = ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * 0.5f;
     }
 }
 
 float Player::get_hunger() const {
-    return std::min(1.0f, float(killTime) / float(KILL_TIME));
+    return std::min(1.0f, float(killTime) / float(g_tunables.kill_time));
 }
 
 float Player::get_random_input() const {
-    static thread_local std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
-    static thread_local std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-    return dist(rng);
+    return sim_rand_float() * 2.0f - 1.0f;
 }
 
 // --- Gene Pool System ---
 std::vector<Player::GeneEntry> Player::gene_pool;
+uint64_t Player::gene_pool_version = 0;
 float Player::last_inserted_fitness = 0.0f;
 float Player::get_last_inserted_fitness() { return last_inserted_fitness; }
 
+// --- Gene pool index (GENE_POOL_MIN_NOVELTY) ---
+namespace {
+    GenomeIndex pool_index;           // rows of the gene pool entries (GeneEntry::index_row)
+    bool pool_index_built = false;
+    uint64_t pool_index_version = 0;  // gene_pool_version the index matches
+
+    // Rebuilds the index after the pool was changed by anything but try_insert_gene_to_pool,
+    // or once removed rows outnumber the live ones
+    void sync_pool_index() {
+        auto& pool = Player::gene_pool;
+        if (pool_index_built && pool_index_version == Player::gene_pool_version && pool_index.rows() <= 2 * pool.size() + 16) return;
+        for (size_t i = 0; i < pool.size(); ++i) pool[i].index_row = int(i);
+        pool_index.build(pool);
+        pool_index_built = true;
+        pool_index_version = Player::gene_pool_version;
+    }
+}
+
 void Player::try_insert_gene_to_pool(float fitness, const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases) {
     if (genes.empty() || biases.empty()) return;
+    constexpr bool novelty = GENE_POOL_MIN_NOVELTY > 0.0f;
+    // A near copy of a pool entry only competes with that entry
+    auto target = gene_pool.end();
+    if (novelty) {
+        sync_pool_index();
+        float dist = 0.0f;
+        int row = pool_index.nearest(genes, biases, dist);
+        if (row >= 0 && dist < GENE_POOL_MIN_NOVELTY) {
+            target = std::find_if(gene_pool.begin(), gene_pool.end(), [&](const GeneEntry& e) { return e.index_row == row; });
+            if (target != gene_pool.end() && target->fitness >= fitness) return;
+        }
+    }
     bool updated = false;
-    if (gene_pool.size() < GENE_POOL_SIZE) {
+    if (target == gene_pool.end() && (int)gene_pool.size() < g_tunables.gene_pool_size) {
         gene_pool.push_back({fitness, genes, biases});
+        target = gene_pool.end() - 1;
         update_hall_of_fame(fitness, genes, biases);
         updated = true;
         last_inserted_fitness = fitness;
     } else {
-        auto min_it = std::min_element(gene_pool.begin(), gene_pool.end(), [](const GeneEntry& a, const GeneEntry& b) { return a.fitness < b.fitness; });
-        if (fitness > min_it->fitness) {
-            *min_it = {fitness, genes, biases};
+        if (target == gene_pool.end()) {
+            target = std::min_element(gene_pool.begin(), gene_pool.end(), [](const GeneEntry& a, const GeneEntry& b) { return a.fitness < b.fitness; });
+        }
+        if (fitness > target->fitness) {
+            if (novelty) pool_index.remove(target->index_row);
+            *target = {fitness, genes, biases};
             update_hall_of_fame(fitness, genes, biases);
             updated = true;
             last_inserted_fitness = fitness;
@@ -557,6 +610,7 @@ void Player::try_insert_gene_to_pool(float fitness, const std::vector<std::vecto
             return;
         }
     }
+    if (novelty) target->index_row = pool_index.insert(*target);
     if (updated) {
         // Efficiently compute best and avg fitness in one pass
         float avg_fitness = 0.0f;
@@ -567,44 +621,24 @@ void Player::try_insert_gene_to_pool(float fitness, const std::vector<std::vecto
         }
         avg_fitness /= gene_pool.size();
         set_display_fitness(best_fitness, avg_fitness, fitness);
-        // Efficiently compute average diversity (pairwise genetic distance) in parallel
-        float diversity_sum = 0.0f;
-        int diversity_count = 0;
-        size_t n = gene_pool.size();
-        #pragma omp parallel for reduction(+:diversity_sum,diversity_count) schedule(static)
-        for (int i = 0; i < (int)n; ++i) {
-            for (int j = i + 1; j < (int)n; ++j) {
-                diversity_sum += genetic_distance(gene_pool[i], gene_pool[j]);
-                diversity_count++;
-            }
-        }
-        float avg_diversity = (diversity_count > 0) ? (diversity_sum / diversity_count) : 0.0f;
-        set_display_diversity(avg_diversity);
+        // Average diversity (pairwise genetic distance), on the thread pool when the pool is large
+        PROFILE_SCOPE(Diversity);
+        set_display_diversity(mean_pairwise_distance(gene_pool));
     }
     std::sort(gene_pool.begin(), gene_pool.end(), [](const GeneEntry& a, const GeneEntry& b) { return a.fitness > b.fitness; });
+    gene_pool_changed();
+    if (novelty) pool_index_version = gene_pool_version; // kept in step above
 }
 
 void Player::save_gene_pool(const std::string& filename) {
     std::ofstream ofs(filename);
     ofs << "GENE_POOL\n";
-    for (const auto& entry : gene_pool) {
-        ofs << "FITNESS " << entry.fitness << "\n";
-        ofs << "GENES\n";
-        for (const auto& layer : entry.genes) {
-            for (float w : layer) ofs << w << ' ';
-            ofs << '\n';
-        }
-        ofs << "BIASES\n";
-        for (const auto& bias : entry.biases) {
-            for (float b : bias) ofs << b << ' ';
-            ofs << '\n';
-        }
-        ofs << "END\n";
-    }
+    write_gene_entries(ofs, gene_pool);
 }
 
 void Player::load_gene_pool(const std::string& filename) {
     gene_pool.clear();
+    gene_pool_changed();
     std::ifstream ifs(filename);
     if (!ifs) return;
     std::string line;
@@ -637,14 +671,75 @@ void Player::load_gene_pool(const std::string& filename) {
     }
     // Keep pool sorted descending
     std::sort(gene_pool.begin(), gene_pool.end(), [](const GeneEntry& a, const GeneEntry& b) { return a.fitness > b.fitness; });
+    gene_pool_changed();
 }
 
-Player::GeneEntry Player::sample_gene_from_pool() {
+const Player::GeneEntry& Player::sample_gene_from_pool() {
     if (gene_pool.empty()) throw std::runtime_error("Gene pool is empty");
-    int idx = rand() % gene_pool.size();
+    int idx = sim_rand() % gene_pool.size();
     return gene_pool[idx];
 }
 
+// --- Binary genome format ---
+// Layout: magic, fitness, layer count, then for genes and biases each layer as (count, floats)
+namespace {
+    constexpr uint32_t GENOME_BINARY_MAGIC = 0x314E4547; // "GEN1"
+
+    template <typename T>
+    void append_raw(std::vector<char>& out, const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    bool read_raw(const char*& cursor, const char* end, T& value) {
+        if (end - cursor < (std::ptrdiff_t)sizeof(T)) return false;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+
+    void append_layers(std::vector<char>& out, const std::vector<std::vector<float>>& layers) {
+        for (const auto& layer : layers) {
+            append_raw(out, static_cast<uint32_t>(layer.size()));
+            const char* bytes = reinterpret_cast<const char*>(layer.data());
+            out.insert(out.end(), bytes, bytes + layer.size() * sizeof(float));
+        }
+    }
+
+    bool read_layers(const char*& cursor, const char* end, uint32_t layer_count, std::vector<std::vector<float>>& layers) {
+        layers.assign(layer_count, {});
+        for (auto& layer : layers) {
+            uint32_t n = 0;
+            if (!read_raw(cursor, end, n)) return false;
+            if ((size_t)(end - cursor) < n * sizeof(float)) return false;
+            layer.resize(n);
+            std::memcpy(layer.data(), cursor, n * sizeof(float));
+            cursor += n * sizeof(float);
+        }
+        return true;
+    }
+}
+
+void Player::write_gene_entry_binary(const GeneEntry& entry, std::vector<char>& out) {
+    out.clear();
+    append_raw(out, GENOME_BINARY_MAGIC);
+    append_raw(out, entry.fitness);
+    append_raw(out, static_cast<uint32_t>(entry.genes.size()));
+    append_layers(out, entry.genes);
+    append_layers(out, entry.biases);
+}
+
+bool Player::read_gene_entry_binary(const char* data, size_t size, GeneEntry& entry) {
+    const char* cursor = data;
+    const char* end = data + size;
+    uint32_t magic = 0, layer_count = 0;
+    if (!read_raw(cursor, end, magic) || magic != GENOME_BINARY_MAGIC) return false;
+    if (!read_raw(cursor, end, entry.fitness)) return false;
+    if (!read_raw(cursor, end, layer_count) || layer_count != NEURAL_NET_SHAPE.size()) return false;
+    return read_layers(cursor, end, layer_count, entry.genes) && read_layers(cursor, end, layer_count, entry.biases);
+}
+
 HumanPlayer::HumanPlayer(int width, int height, SDL_Color color, float x, float y, bool alive)
     : Player(width, height, color, x, y, alive)
 {
@@ -655,7 +750,7 @@ void HumanPlayer::update(Game& game) {
     lifeTime++;
     killTime++;
     update_exploration_cell(Game::CELL_SIZE, game.width, game.height);
-    if (killTime >= KILL_TIME) {
+    if (killTime >= g_tunables.kill_time) {
         killTime = 0;
         if (foodCount > 0) {
             int food_loss = std::ceil(1 + 0.05 * std::sqrt(width));
@@ -663,17 +758,17 @@ void HumanPlayer::update(Game& game) {
                 decrease_size_step();
             }
         } else if (KILL) {
-            alive = false;
+            game.kill_player(*this);
         }
     }
     if (!alive) return;
-    int mouse_x, mouse_y;
-    SDL_GetMouseState(&mouse_x, &mouse_y);
-    float dx = mouse_x - x;
-    float dy = mouse_y - y;
+    float target_x = game.pointer_x.load(std::memory_order_relaxed);
+    float target_y = game.pointer_y.load(std::memory_order_relaxed);
+    float dx = target_x - x;
+    float dy = target_y - y;
     float dist = std::sqrt(dx * dx + dy * dy);
     // decrease size - curved
-    float size_factor = std::pow(float(DOT_WIDTH) / float(width), PLAYER_SIZE_SPEED_EXPONENT);
+    float size_factor = size_speed_factor(width);
     size_factor = std::max(size_factor, PLAYER_MIN_SPEED_FACTOR);
     float effective_max_speed = MAX_SPEED * size_factor;
     float move_speed = effective_max_speed * (1.0f - std::exp(-dist / 50.0f));
@@ -688,19 +783,13 @@ void HumanPlayer::update(Game& game) {
         }
         x += move_x;
         y += move_y;
-        angle = std::atan2(move_y, move_x);
+        angle = sim_atan2(move_y, move_x);
         speed = move_speed;
     } else {
         speed = 0.0f;
     }
     clamp_to_screen(game);
     eatFood(game);
-    auto nearby_players = game.get_nearby_players(x, y);
-    for (auto* other : nearby_players) {
-        if (other->alive && other != this) {
-            eatPlayer(game, *other);
-        }
-    }
     last_angle = angle;
     last_speed = speed;
 }
@@ -710,18 +799,18 @@ std::vector<std::vector<float>> crossover_biases(const std::vector<std::vector<f
     std::vector<std::vector<float>> result = b1;
     for (size_t l = 0; l < b1.size(); ++l) {
         int size = b1[l].size();
-        int method = rand() % 3; // 0: uniform, 1: single-point, 2: arithmetic
+        int method = sim_rand() % 3; // 0: uniform, 1: single-point, 2: arithmetic
         if (method == 0) { // Uniform crossover
             for (int i = 0; i < size; ++i) {
-                result[l][i] = (rand() % 2 == 0) ? b1[l][i] : b2[l][i];
+                result[l][i] = (sim_rand() % 2 == 0) ? b1[l][i] : b2[l][i];
             }
         } else if (method == 1) { // Single-point crossover
-            int point = rand() % size;
+            int point = sim_rand() % size;
             for (int i = 0; i < size; ++i) {
                 result[l][i] = (i < point) ? b1[l][i] : b2[l][i];
             }
         } else { // Arithmetic crossover
-            float alpha = ((float)rand() / RAND_MAX);
+            float alpha = ((float)sim_rand() / SIM_RAND_MAX);
             for (int i = 0; i < size; ++i) {
                 result[l][i] = alpha * b1[l][i] + (1.0f - alpha) * b2[l][i];
             }
@@ -732,6 +821,7 @@ std::vector<std::vector<float>> crossover_biases(const std::vector<std::vector<f
 
 // Hall of Fame for all-time best genes
 std::vector<Player::GeneEntry> Player::hall_of_fame;
+std::string Player::hall_of_fame_file = "hall_of_fame.txt";
 
 void Player::update_hall_of_fame(float fitness, const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases) {
     // Insert if not full, or replace worst if better
@@ -746,32 +836,19 @@ void Player::update_hall_of_fame(float fitness, const std::vector<std::vector<fl
         }
     }
     std::sort(hall_of_fame.begin(), hall_of_fame.end(), [](const GeneEntry& a, const GeneEntry& b) { return a.fitness > b.fitness; });
-    save_hall_of_fame("hall_of_fame.txt");
+    if (!hall_of_fame_file.empty()) save_hall_of_fame(hall_of_fame_file);
 }
 
-Player::GeneEntry Player::sample_hall_of_fame() {
+const Player::GeneEntry& Player::sample_hall_of_fame() {
     if (hall_of_fame.empty()) throw std::runtime_error("Hall of Fame is empty");
-    int idx = rand() % hall_of_fame.size();
+    int idx = sim_rand() % hall_of_fame.size();
     return hall_of_fame[idx];
 }
 
 void Player::save_hall_of_fame(const std::string& filename) {
     std::ofstream ofs(filename);
     ofs << "HALL_OF_FAME\n";
-    for (const auto& entry : hall_of_fame) {
-        ofs << "FITNESS " << entry.fitness << "\n";
-        ofs << "GENES\n";
-        for (const auto& layer : entry.genes) {
-            for (float w : layer) ofs << w << ' ';
-            ofs << '\n';
-        }
-        ofs << "BIASES\n";
-        for (const auto& bias : entry.biases) {
-            for (float b : bias) ofs << b << ' ';
-            ofs << '\n';
-        }
-        ofs << "END\n";
-    }
+    write_gene_entries(ofs, hall_of_fame);
 }
 
 void Player::load_hall_of_fame(const std::string& filename) {
@@ -812,71 +889,58 @@ void Player::load_hall_of_fame(const std::string& filename) {
 float Player::adaptive_mutation_rate = MUTATION_RATE;
 
 float Player::genetic_distance(const GeneEntry& a, const GeneEntry& b) {
-    float dist = 0.0f;
-    int count = 0;
+    L1Lanes dist;
     for (size_t l = 0; l < a.genes.size(); ++l) {
-        for (size_t i = 0; i < a.genes[l].size(); ++i) {
-            dist += std::abs(a.genes[l][i] - b.genes[l][i]);
-            ++count;
-        }
-        for (size_t i = 0; i < a.biases[l].size(); ++i) {
-            dist += std::abs(a.biases[l][i] - b.biases[l][i]);
-            ++count;
-        }
+        dist.add(a.genes[l].data(), b.genes[l].data(), a.genes[l].size());
+        dist.add(a.biases[l].data(), b.biases[l].data(), a.biases[l].size());
     }
-    return dist / count;
+    return dist.total() / float(dist.next);
 }
 
 void Player::prune_gene_pool_diversity(float min_distance) {
     if (gene_pool.size() < 5) return; // Don't prune if pool is too small
     int before = gene_pool.size();
-    int n_to_remove = std::max(1, int(gene_pool.size() * PRUNE_RATE));
-    int elite_count = std::max(1, int(gene_pool.size() * ELITISM_PERCENT));
+    int n_to_remove = std::max(1, int(gene_pool.size() * g_tunables.prune_rate));
+    int elite_count = std::max(1, int(gene_pool.size() * g_tunables.elitism_percent));
     std::sort(gene_pool.begin(), gene_pool.end(), [](const GeneEntry& a, const GeneEntry& b) { return a.fitness > b.fitness; });
     std::vector<GeneEntry> new_pool(gene_pool.begin(), gene_pool.begin() + elite_count);
     // Prepare the rest for diversity pruning
     std::vector<GeneEntry> candidates(gene_pool.begin() + elite_count, gene_pool.end());
-    // Calculate avg diversity before pruning
-    float diversity_sum_before = 0.0f;
-    int diversity_count_before = 0;
-    size_t pool_size = gene_pool.size();
-    #pragma omp parallel for reduction(+:diversity_sum_before,diversity_count_before) schedule(static)
-    for (int i = 0; i < (int)pool_size; ++i) {
-        for (int j = i + 1; j < (int)pool_size; ++j) {
-            diversity_sum_before += genetic_distance(gene_pool[i], gene_pool[j]);
-            diversity_count_before++;
-        }
+    // Remove the most redundant entries: each time the candidate whose nearest remaining
+    // candidate is closest, while that is below min_distance (ties: the less fit one). The
+    // nearest distances come from a GenomeIndex and are only queried again for the candidates
+    // whose nearest was just removed. Only neighbours within min_distance are looked for: a
+    // candidate without one never qualifies, as removals only move its nearest further away.
+    const size_t m = candidates.size();
+    std::vector<bool> to_remove(m, false);
+    GenomeIndex index;
+    index.build(candidates);
+    std::vector<int> nearest_row(m);
+    std::vector<float> nearest_dist(m);
+    ThreadPool::shared().parallel_for(m, GENOME_QUERY_WORK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) nearest_row[i] = index.nearest(int(i), nearest_dist[i], min_distance);
+    });
+    // Smallest distance first, then the last candidate (the less fit, as they are sorted by
+    // fitness): both ends of the closest pair have the same distance. An item is stale once its
+    // candidate's distance changed.
+    using Closest = std::pair<float, int>;
+    auto later = [](const Closest& a, const Closest& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; };
+    std::priority_queue<Closest, std::vector<Closest>, decltype(later)> closest(later);
+    for (size_t i = 0; i < m; ++i) {
+        if (nearest_row[i] >= 0) closest.push({nearest_dist[i], int(i)});
     }
-    float avg_diversity_before = (diversity_count_before > 0) ? (diversity_sum_before / diversity_count_before) : 0.0f;
-    // Parallel pairwise distance matrix for candidates
-    std::vector<std::vector<float>> distances(candidates.size(), std::vector<float>(candidates.size(), 0.0f));
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < (int)candidates.size(); ++i) {
-        for (int j = i + 1; j < (int)candidates.size(); ++j) {
-            float dist = genetic_distance(candidates[i], candidates[j]);
-            distances[i][j] = dist;
-            distances[j][i] = dist;
-        }
-    }
-    std::vector<bool> to_remove(candidates.size(), false);
-    // Remove the most redundant (least diverse, lowest fitness) entries
     for (int k = 0; k < n_to_remove; ++k) {
-        int worst_idx = -1;
-        float min_div = 1e9f;
-        for (size_t i = 0; i < candidates.size(); ++i) {
-            if (to_remove[i]) continue;
-            float min_dist = 1e9f;
-            for (size_t j = 0; j < candidates.size(); ++j) {
-                if (i == j || to_remove[j]) continue;
-                if (distances[i][j] < min_dist) min_dist = distances[i][j];
-            }
-            // If two are too close, prefer to remove the one with lower fitness
-            if (min_dist < min_distance && min_dist < min_div) {
-                min_div = min_dist;
-                worst_idx = i;
-            }
+        while (!closest.empty() && (to_remove[closest.top().second] || closest.top().first != nearest_dist[closest.top().second])) closest.pop();
+        if (closest.empty() || closest.top().first >= min_distance) break;
+        const int worst = closest.top().second;
+        closest.pop();
+        to_remove[worst] = true;
+        index.remove(worst);
+        for (size_t j = 0; j < m; ++j) {
+            if (to_remove[j] || nearest_row[j] != worst) continue;
+            nearest_row[j] = index.nearest(int(j), nearest_dist[j], min_distance);
+            if (nearest_row[j] >= 0) closest.push({nearest_dist[j], int(j)});
         }
-        if (worst_idx >= 0) to_remove[worst_idx] = true;
     }
     int removed = 0;
     // Add remaining diverse candidates to the pool
@@ -886,25 +950,13 @@ void Player::prune_gene_pool_diversity(float min_distance) {
     }
     // Remove the refill part: do not fill up new_pool to before size
     int after = new_pool.size();
-    // Diversity info: recalculate for new_pool only (parallelized)
-    float diversity_sum = 0.0f;
-    int diversity_count = 0;
-    size_t new_pool_size = new_pool.size();
-    #pragma omp parallel for reduction(+:diversity_sum,diversity_count) schedule(static)
-    for (int i = 0; i < (int)new_pool_size; ++i) {
-        for (int j = i + 1; j < (int)new_pool_size; ++j) {
-            diversity_sum += genetic_distance(new_pool[i], new_pool[j]);
-            diversity_count++;
-        }
-    }
-    float avg_diversity = (diversity_count > 0) ? (diversity_sum / diversity_count) : 0.0f;
     if (removed > 0) {
         // std::cout << "[PRUNE] removed: " << removed
         //           << ", elites kept: " << elite_count
-        //           << ", avg diversity: " << avg_diversity
         //           << std::endl;
     }
     gene_pool = new_pool;
+    gene_pool_changed();
 }
 
 // Helper to generate random genes and biases
@@ -916,7 +968,7 @@ std::pair<std::vector<std::vector<float>>, std::vector<std::vector<float>>> rand
         std::vector<float> layer(in * out);
         std::vector<float> bias(out);
         float a = std::sqrt(6.0f / (in + out));
-        for (auto& w : layer) w = ((float)rand() / RAND_MAX * 2 - 1) * a;
+        for (auto& w : layer) w = ((float)sim_rand() / SIM_RAND_MAX * 2 - 1) * a;
         for (auto& b : bias) b = 0.0f;
         genes.push_back(layer);
         biases.push_back(bias);
@@ -2,11 +2,17 @@
 #include <vector>
 #include <array>
 #include "Settings.h"
+#include "QuantizedNet.h"
+#include "SparseNet.h"
+#include "Sensing.h"
 #include <SDL.h>
 #include <random>
 #include <memory>
 #include <set>
 #include <utility>
+#include <string>
+#include <limits>
+#include <cstdint>
 class Game;
 
 // Helper struct for NN input and dx/dy values
@@ -20,16 +26,31 @@ public:
     Player(int width = DOT_WIDTH, int height = DOT_HEIGHT, SDL_Color color = DOT_COLOR, float x = 0, float y = 0, bool alive = true);
     Player(const std::vector<std::vector<float>>& parent_genes, int width, int height, SDL_Color color, float x, float y, int parent_id = -1);
     Player(const std::vector<std::vector<float>>& parent_genes, const std::vector<std::vector<float>>& parent_biases, int width, int height, SDL_Color color, float x, float y, int parent_id = -1);
+    virtual ~Player() = default; // hunters are deleted through Player*
     virtual void update(Game& game);
     std::array<float, NN_OUTPUTS> predict(const std::array<float, NN_INPUTS>& input);
+    // The network alone: tanh (angle) and sigmoid (speed) outputs, before predict's scaling and noise
+    std::array<float, NN_OUTPUTS> forward(const std::array<float, NN_INPUTS>& input) const;
     std::vector<std::vector<float>> genes; // Neural net weights (per layer: weights)
     std::vector<std::vector<float>> biases; // Neural net biases (per layer: biases)
+    QuantizedNet qnet; // reduced-precision copy of genes/biases that predict() runs (empty in fp32 mode)
+    void quantize_network(); // rebuilds qnet for g_inference_mode; call after changing genes or biases
+    // Pruned copy of the network (see SparseNet.h), compiled once the bot is long-lived or came
+    // from the hall of fame; a quantized qnet takes precedence
+    std::unique_ptr<SparseNet> sparse_net;
+    void compile_sparse_network();
     std::pair<std::vector<std::vector<float>>, std::vector<std::vector<float>>> mitosis(bool mutate = true);
     bool collide(const Player& other) const;
     virtual bool eatPlayer(Game& game, Player& other);
     virtual bool eatFood(Game& game);
-    virtual void draw(SDL_Renderer* renderer);
+    static uint32_t next_uid();
+    // Restarts the uids at 1, for runs that must match a previous one; live players keep theirs
+    static void reset_uids();
+    const uint32_t uid = next_uid(); // never reused, identifies the player in replays
     float x, y;
+    // Position before the current tick (NaN until the first tick), for render interpolation
+    float prev_x = std::numeric_limits<float>::quiet_NaN();
+    float prev_y = std::numeric_limits<float>::quiet_NaN();
     int width, height;
     SDL_Color color;
     float speed;
@@ -51,20 +72,12 @@ public:
     float last_nn_hunter_dx = 0.0f, last_nn_hunter_dy = 0.0f;
     float last_nn_player_dx = 0.0f, last_nn_player_dy = 0.0f;
     float distance_traveled = 0.0f;
-    // For input smoothing (temporal smoothing)
-    float smoothed_food_dist = 0.0f;
-    float smoothed_food_angle = 0.0f;
-    float smoothed_player_dist = 0.0f;
-    float smoothed_player_angle = 0.0f;
-    float smoothed_left_wall = 0.0f;
-    float smoothed_right_wall = 0.0f;
-    float smoothed_top_wall = 0.0f;
-    float smoothed_bottom_wall = 0.0f;
-    float smoothed_speed = 0.0f;
-    float smoothed_size_diff = 0.0f;
-    float smoothed_own_norm_size = 0.0f;
-    float smoothed_own_food_count = 0.0f;
+    // Smoothed network inputs (low-pass filtered, see smooth_inputs), in input order
+    std::array<float, NN_INPUTS> smoothed_inputs{};
+    int sensor_slot = -1; // index in Game::sensors during the tick it was sensed in
+    SensorCache sensor_cache; // nearest food / player of the last pass (LAZY_SENSING)
     int time_near_wall = 0; // Counts frames spent near wall/corner
+    float novelty = 0.0f; // behavioural novelty at the last scoring (NoveltySearch), 0 until then
     void initialize_weights_xavier();
     NNInputsResult get_nn_inputs(const Game& game);
     void apply_nn_output(const std::array<float, NN_OUTPUTS>& nn_output);
@@ -75,13 +88,22 @@ public:
         float fitness;
         std::vector<std::vector<float>> genes;
         std::vector<std::vector<float>> biases;
+        int index_row = -1; // row in the gene pool's GenomeIndex, while one is kept (GENE_POOL_MIN_NOVELTY)
     };
     static std::vector<GeneEntry> gene_pool;
+    // Bumped whenever gene_pool changes, so samplers built from it know to rebuild. The
+    // functions below bump it; code that writes gene_pool directly calls gene_pool_changed()
+    static uint64_t gene_pool_version;
+    static void gene_pool_changed() { ++gene_pool_version; }
     static void try_insert_gene_to_pool(float fitness, const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases);
     static void save_gene_pool(const std::string& filename = "gene_pool.txt");
     static void load_gene_pool(const std::string& filename = "gene_pool.txt");
-    static GeneEntry sample_gene_from_pool();
+    static const GeneEntry& sample_gene_from_pool();
+    // Binary genome format: compact, native-endian encoding of a GeneEntry (used for island migration)
+    static void write_gene_entry_binary(const GeneEntry& entry, std::vector<char>& out);
+    static bool read_gene_entry_binary(const char* data, size_t size, GeneEntry& entry);
     bool is_human = false;
+    bool is_hunter = false; // set by Hunter
     void clamp_to_screen(const Game& game);
     void update_size_from_food();
     void decrease_size_step();
@@ -90,6 +112,13 @@ public:
     static constexpr int MAX_FOOD = 2000;
     static int food_to_size[MAX_FOOD + 1];
     static int size_to_food[MAX_PLAYER_SIZE + 1];
+    // pow() terms of the tick per size, exact values precomputed by init_lookup_tables
+    static float speed_factor_by_size[MAX_PLAYER_SIZE + 1]; // (DOT_WIDTH / size)^PLAYER_SIZE_SPEED_EXPONENT
+    static double hunger_pow_by_size[MAX_PLAYER_SIZE + 1];  // size^hunger_exponent
+    static float hunger_pow_exponent;                       // the hunger_exponent of hunger_pow_by_size
+    static float size_speed_factor(int size);
+    // Falls back to std::pow for other exponents (tunables changed since the tables were built)
+    static double hunger_size_pow(int size, float exponent);
     static void init_lookup_tables();
     static bool lookup_tables_initialized;
 
@@ -99,8 +128,9 @@ public:
     // Hall of Fame for all-time best genes
     static std::vector<GeneEntry> hall_of_fame;
     static constexpr int HALL_OF_FAME_SIZE = 10;
+    static std::string hall_of_fame_file; // Where update_hall_of_fame persists the HOF (empty = never)
     static void update_hall_of_fame(float fitness, const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases);
-    static GeneEntry sample_hall_of_fame();
+    static const GeneEntry& sample_hall_of_fame();
     static void save_hall_of_fame(const std::string& filename = "hall_of_fame.txt");
     static void load_hall_of_fame(const std::string& filename = "hall_of_fame.txt");
 
@@ -0,0 +1,68 @@
+#include "Population.h"
+#include "Player.h"
+#include <algorithm>
+
+bool TopBots::eligible(const Player* p) {
+    return p && p->alive && !p->is_human && !p->is_hunter;
+}
+
+bool TopBots::better(const Entry& a, const Entry& b) {
+    return a.food != b.food ? a.food > b.food : a.uid < b.uid;
+}
+
+int TopBots::find(const Player* p) const {
+    for (int i = 0; i < int(heap.size()); ++i) {
+        if (heap[i].player == p) return i;
+    }
+    return -1;
+}
+
+void TopBots::offer(Player* p) const {
+    Entry entry{p->foodCount, p->uid, p};
+    if (int(heap.size()) < K) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), better);
+    } else if (better(entry, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = entry;
+        std::push_heap(heap.begin(), heap.end(), better);
+    }
+}
+
+void TopBots::update(Player* p) {
+    if (stale || !eligible(p)) return; // a stale board is rebuilt from scratch on the next read
+    int i = find(p);
+    if (i < 0) {
+        offer(p);
+    } else if (p->foodCount >= heap[i].food) {
+        heap[i].food = p->foodCount;
+        std::make_heap(heap.begin(), heap.end(), better);
+    } else {
+        stale = true; // a bot off the board may now be ahead of it
+    }
+}
+
+void TopBots::remove(const Player* p) {
+    if (!stale && find(p) >= 0) stale = true;
+}
+
+void TopBots::clear() {
+    heap.clear();
+    stale = false;
+}
+
+const std::vector<Player*>& TopBots::top(const std::vector<Player*>& players) const {
+    if (stale) {
+        heap.clear();
+        for (auto* p : players) {
+            if (eligible(p)) offer(p);
+        }
+        stale = false;
+        ++rescans;
+    }
+    order.assign(heap.begin(), heap.end());
+    std::sort(order.begin(), order.end(), better);
+    sorted.clear();
+    for (const auto& e : order) sorted.push_back(e.player);
+    return sorted;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+class Player;
+
+// Alive players by kind, kept current by Game::add_player, Game::kill_player and Game::reset
+struct PopulationCounts {
+    int bots = 0;    // neither hunters nor humans
+    int humans = 0;
+    int hunters = 0;
+    int alive() const { return bots + humans + hunters; }
+};
+
+// The K alive bots with the most food (ties: lower uid first), kept in a bounded min-heap that
+// is updated on events instead of sorting the population per frame:
+//   - a bot that spawns or eats is offered, replacing the worst entry if it beats it
+//   - a board member that shrinks or dies leaves the board stale; the next read rescans the
+//     players once, so the board is always the exact top K when read
+class TopBots {
+public:
+    static constexpr int K = 5;
+    // p's food count changed, or it spawned
+    void update(Player* p);
+    // p died
+    void remove(const Player* p);
+    void clear();
+    // Rebuild from the players on the next read
+    void invalidate() { stale = true; }
+    // Best first
+    const std::vector<Player*>& top(const std::vector<Player*>& players) const;
+    mutable long long rescans = 0; // full scans after a member dropped out
+
+private:
+    struct Entry {
+        int food;
+        uint32_t uid;
+        Player* player;
+    };
+    static bool eligible(const Player* p);
+    static bool better(const Entry& a, const Entry& b);
+    void offer(Player* p) const;
+    int find(const Player* p) const;
+
+    mutable std::vector<Entry> heap; // worst at the front
+    mutable bool stale = false;
+    mutable std::vector<Entry> order; // read scratch
+    mutable std::vector<Player*> sorted;
+};
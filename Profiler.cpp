@@ -0,0 +1,49 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <limits>
+
+thread_local std::array<uint64_t, TickProfiler::PHASES> TickProfiler::current{};
+std::array<std::array<uint32_t, TickProfiler::WINDOW>, TickProfiler::PHASES> TickProfiler::window{};
+int TickProfiler::window_pos = 0;
+int TickProfiler::window_count = 0;
+
+void TickProfiler::begin_tick() {
+    current.fill(0);
+}
+
+void TickProfiler::end_tick() {
+    for (int p = 0; p < PHASES; ++p) {
+        window[p][window_pos] = static_cast<uint32_t>(std::min<uint64_t>(current[p], std::numeric_limits<uint32_t>::max()));
+    }
+    window_pos = (window_pos + 1) % WINDOW;
+    window_count = std::min(window_count + 1, WINDOW);
+}
+
+float TickProfiler::percentile_us(ProfilePhase phase, float q) {
+    if (window_count == 0) return 0.0f;
+    std::array<uint32_t, WINDOW> sorted;
+    const auto& samples = window[static_cast<int>(phase)];
+    std::copy(samples.begin(), samples.begin() + window_count, sorted.begin());
+    int k = std::clamp(int(q * (window_count - 1) + 0.5f), 0, window_count - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.begin() + window_count);
+    return sorted[k] / 1000.0f;
+}
+
+const char* TickProfiler::phase_name(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Tick: return "tick";
+        case ProfilePhase::GridRebuild: return "grids";
+        case ProfilePhase::Players: return "players";
+        case ProfilePhase::Sensing: return " sense";
+        case ProfilePhase::Inference: return " infer";
+        case ProfilePhase::Movement: return " move";
+        case ProfilePhase::Eating: return " eat";
+        case ProfilePhase::Hunters: return "hunters";
+        case ProfilePhase::Collisions: return "collisions";
+        case ProfilePhase::Food: return "food";
+        case ProfilePhase::MaintainPopulation: return "population";
+        case ProfilePhase::Prune: return " prune";
+        case ProfilePhase::Diversity: return " diversity";
+        default: return "?";
+    }
+}
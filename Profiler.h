@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "Settings.h"
+
+// Per-phase tick profiler with rolling p50/p99 percentiles.
+// The timers are compiled in only when SIM_PROFILER is defined (CMake option ENABLE_PROFILER);
+// otherwise PROFILE_SCOPE expands to nothing and the percentiles read as zero.
+// PROFILE_AGENT_SCOPE times the sub-phases of a single agent's update. Those run for every bot
+// every tick, where two clock reads cost more than some of the work they time, so they also
+// need SIM_AGENT_PROFILER (ENABLE_AGENT_PROFILER, off by default); without it only the batched
+// sensing is counted and Inference, Movement and Eating read as zero.
+enum class ProfilePhase : int {
+    Tick,
+    GridRebuild,
+    Players,
+    Sensing,   // part of Players
+    Inference, // part of Players
+    Movement,  // part of Players
+    Eating,    // part of Players
+    Hunters,
+    Collisions,
+    Food,
+    MaintainPopulation,
+    Prune,     // part of MaintainPopulation
+    Diversity, // part of MaintainPopulation
+    Count
+};
+
+class TickProfiler {
+public:
+    static constexpr int PHASES = static_cast<int>(ProfilePhase::Count);
+    static constexpr int WINDOW = PROFILER_WINDOW; // ticks kept for the rolling percentiles
+
+    static void begin_tick();
+    // Moves this tick's per-phase totals into the rolling window
+    static void end_tick();
+    static void add(ProfilePhase phase, uint64_t ns) { current[static_cast<int>(phase)] += ns; }
+    // q in [0, 1]; result in microseconds per tick
+    static float percentile_us(ProfilePhase phase, float q);
+    static const char* phase_name(ProfilePhase phase);
+    static int samples() { return window_count; }
+    static constexpr bool enabled() {
+#ifdef SIM_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    static thread_local std::array<uint64_t, PHASES> current; // per thread: evaluation scenarios step games concurrently
+    static std::array<std::array<uint32_t, WINDOW>, PHASES> window; // ns per tick, saturated
+    static int window_pos;
+    static int window_count;
+};
+
+// Adds the lifetime of the object to a phase
+class ScopedPhaseTimer {
+public:
+    explicit ScopedPhaseTimer(ProfilePhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhaseTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        TickProfiler::add(phase, static_cast<uint64_t>(ns));
+    }
+private:
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef SIM_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) ScopedPhaseTimer PROFILE_CONCAT(profile_scope_, __LINE__)(ProfilePhase::phase)
+#define PROFILE_BEGIN_TICK() TickProfiler::begin_tick()
+#define PROFILE_END_TICK() TickProfiler::end_tick()
+#else
+#define PROFILE_SCOPE(phase) ((void)0)
+#define PROFILE_BEGIN_TICK() ((void)0)
+#define PROFILE_END_TICK() ((void)0)
+#endif
+#if defined(SIM_PROFILER) && defined(SIM_AGENT_PROFILER)
+#define PROFILE_AGENT_SCOPE(phase) PROFILE_SCOPE(phase)
+#else
+#define PROFILE_AGENT_SCOPE(phase) ((void)0)
+#endif
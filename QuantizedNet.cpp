@@ -0,0 +1,135 @@
+#include "QuantizedNet.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+InferenceMode g_inference_mode = InferenceMode::Float32;
+
+const char* inference_mode_name(InferenceMode mode) {
+    switch (mode) {
+        case InferenceMode::Int8: return "int8";
+        case InferenceMode::Float16: return "fp16";
+        default: return "fp32";
+    }
+}
+
+bool parse_inference_mode(const std::string& text, InferenceMode& mode) {
+    if (text == "fp32") mode = InferenceMode::Float32;
+    else if (text == "int8") mode = InferenceMode::Int8;
+    else if (text == "fp16") mode = InferenceMode::Float16;
+    else return false;
+    return true;
+}
+
+namespace {
+    constexpr int max_layer_width() {
+        int width = 0;
+        for (const auto& layer : NEURAL_NET_SHAPE) width = std::max({width, std::get<0>(layer), std::get<1>(layer)});
+        return width;
+    }
+    constexpr int MAX_LAYER_WIDTH = max_layer_width();
+
+    float leaky_relu(float x) { return x > 0.0f ? x : 0.01f * x; }
+
+    // |value * inv_scale| <= 127 by the choice of scale; the clamp only guards the rounding
+    int8_t quantize(float value, float inv_scale) {
+        const int q = int((value * inv_scale + FAST_ROUNDER) - FAST_ROUNDER);
+        return static_cast<int8_t>(std::clamp(q, -127, 127));
+    }
+
+    // Round to nearest even; magnitudes past the half range saturate to +-65504, and
+    // magnitudes below the smallest normal half (6.1e-5) become zero
+    uint16_t float_to_half(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const uint32_t abs = bits & 0x7fffffffu;
+        if (abs >= 0x477fe000u) return uint16_t(sign | 0x7bffu);
+        if (abs < 0x38800000u) return uint16_t(sign);
+        uint32_t half = (abs - 0x38000000u) >> 13;
+        const uint32_t rest = abs & 0x1fffu;
+        if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;
+        return uint16_t(sign | half);
+    }
+
+    // Only zero and normal halves occur (see float_to_half): placing the half's bits in a float
+    // and scaling by 2^112 rebiases the exponent, with zero staying zero and no branches
+    inline float half_to_float(uint16_t half) {
+        const uint32_t bits = (uint32_t(half & 0x8000u) << 16) | (uint32_t(half & 0x7fffu) << 13);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        value *= 5.192296858534828e33f; // 2^112
+        return value;
+    }
+}
+
+QuantizedNet::QuantizedNet(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, InferenceMode mode) {
+    if (mode == InferenceMode::Float32 || int(genes.size()) != NN_LAYERS || int(biases.size()) != NN_LAYERS) return;
+    for (int l = 0; l < NN_LAYERS; ++l) {
+        const int in = std::get<0>(NEURAL_NET_SHAPE[l]), out = std::get<1>(NEURAL_NET_SHAPE[l]);
+        if (int(genes[l].size()) != in * out || int(biases[l].size()) != out) return;
+    }
+    mode_ = mode;
+    if (mode == InferenceMode::Int8) weights_i8_.resize(NN_WEIGHT_COUNT);
+    else weights_f16_.resize(NN_WEIGHT_COUNT);
+    int offset = 0;
+    for (int l = 0; l < NN_LAYERS; ++l) {
+        const int in = std::get<0>(NEURAL_NET_SHAPE[l]), out = std::get<1>(NEURAL_NET_SHAPE[l]);
+        const std::vector<float>& layer = genes[l]; // [in][out]
+        if (mode == InferenceMode::Int8) {
+            float max_abs = 0.0f;
+            for (float w : layer) max_abs = std::max(max_abs, std::fabs(w));
+            scales_[l] = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+            const float inv_scale = 1.0f / scales_[l];
+            for (int j = 0; j < out; ++j)
+                for (int i = 0; i < in; ++i) weights_i8_[offset + j * in + i] = quantize(layer[i * out + j], inv_scale);
+        } else {
+            for (int k = 0; k < in * out; ++k) weights_f16_[offset + k] = float_to_half(layer[k]);
+        }
+        biases_.insert(biases_.end(), biases[l].begin(), biases[l].end());
+        offset += in * out;
+    }
+}
+
+std::array<float, NN_OUTPUTS> QuantizedNet::forward(const std::array<float, NN_INPUTS>& input) const {
+    std::array<float, MAX_LAYER_WIDTH> activations{}, next{};
+    std::copy(input.begin(), input.end(), activations.begin());
+    int offset = 0, bias_offset = 0;
+    for (int l = 0; l < NN_LAYERS; ++l) {
+        const int in = std::get<0>(NEURAL_NET_SHAPE[l]), out = std::get<1>(NEURAL_NET_SHAPE[l]);
+        const float* bias = biases_.data() + bias_offset;
+        if (mode_ == InferenceMode::Int8) {
+            // Activations get their own symmetric scale per layer, so both operands are int8
+            float max_abs = 0.0f;
+            for (int i = 0; i < in; ++i) max_abs = std::max(max_abs, std::fabs(activations[i]));
+            const float activation_scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+            const float inv_scale = 1.0f / activation_scale;
+            std::array<int8_t, MAX_LAYER_WIDTH> q{};
+            for (int i = 0; i < in; ++i) q[i] = quantize(activations[i], inv_scale);
+            const float rescale = scales_[l] * activation_scale;
+            const int8_t* w = weights_i8_.data() + offset;
+            for (int j = 0; j < out; ++j) {
+                int32_t acc = 0;
+                for (int i = 0; i < in; ++i) acc += int32_t(w[j * in + i]) * int32_t(q[i]);
+                next[j] = float(acc) * rescale + bias[j];
+            }
+        } else {
+            // Row by row, so the inner loop runs across neurons instead of being a float reduction
+            const uint16_t* w = weights_f16_.data() + offset;
+            for (int j = 0; j < out; ++j) next[j] = bias[j];
+            for (int i = 0; i < in; ++i) {
+                const float a = activations[i];
+                for (int j = 0; j < out; ++j) next[j] += half_to_float(w[i * out + j]) * a;
+            }
+        }
+        if (l < NN_LAYERS - 1)
+            for (int j = 0; j < out; ++j) next[j] = leaky_relu(next[j]);
+        activations = next;
+        offset += in * out;
+        bias_offset += out;
+    }
+    std::array<float, NN_OUTPUTS> output;
+    std::copy(activations.begin(), activations.begin() + NN_OUTPUTS, output.begin());
+    return output;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Settings.h"
+
+// Reduced-precision copies of a genome for the forward pass. The float genes stay the genome
+// (mutation, crossover, the gene pool); a Player quantizes them once when it is created, and
+// predict() runs the quantized copy when the inference mode is not fp32.
+//   int8: symmetric per-layer weight scales, activations quantized per layer at run time,
+//         int32 accumulation, one float rescale per neuron
+//   fp16: IEEE half weights (subnormals flushed to zero), widened to float for the multiply-add,
+//         as there is no portable half arithmetic
+enum class InferenceMode { Float32, Int8, Float16 };
+extern InferenceMode g_inference_mode;
+const char* inference_mode_name(InferenceMode mode);
+bool parse_inference_mode(const std::string& text, InferenceMode& mode);
+
+constexpr int nn_weight_count() {
+    int count = 0;
+    for (const auto& layer : NEURAL_NET_SHAPE) count += std::get<0>(layer) * std::get<1>(layer);
+    return count;
+}
+constexpr int NN_WEIGHT_COUNT = nn_weight_count();
+constexpr int NN_LAYERS = int(NEURAL_NET_SHAPE.size());
+
+class QuantizedNet {
+public:
+    QuantizedNet() = default;
+    // Empty (fp32 mode, or genes that do not have the NEURAL_NET_SHAPE layout)
+    QuantizedNet(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, InferenceMode mode);
+    InferenceMode mode() const { return mode_; }
+    bool empty() const { return mode_ == InferenceMode::Float32; }
+    // Output layer before its activation, like the fp32 pass in Player::predict
+    std::array<float, NN_OUTPUTS> forward(const std::array<float, NN_INPUTS>& input) const;
+    size_t weight_bytes() const { return weights_i8_.size() + weights_f16_.size() * sizeof(uint16_t); }
+
+private:
+    InferenceMode mode_ = InferenceMode::Float32;
+    // Weights of every layer back to back: int8 transposed to [out][in], so each neuron is one
+    // contiguous integer dot product; fp16 in the genes' [in][out] order
+    std::vector<int8_t> weights_i8_;
+    std::vector<uint16_t> weights_f16_;
+    std::array<float, NN_LAYERS> scales_{}; // int8: float weight = int8 * scale
+    std::vector<float> biases_;
+};
@@ -0,0 +1,29 @@
+#include "Random.h"
+#include <random>
+
+namespace {
+    std::mt19937& generator() {
+        static thread_local std::mt19937 gen(std::random_device{}());
+        return gen;
+    }
+}
+
+void sim_srand(unsigned int seed) {
+    generator().seed(seed);
+}
+
+int sim_rand() {
+    return static_cast<int>(generator()() >> 1);
+}
+
+float sim_rand_float() {
+    return (generator()() >> 8) * (1.0f / 16777216.0f);
+}
+
+ScopedSimSeed::ScopedSimSeed(unsigned int seed) : saved(generator()) {
+    generator().seed(seed);
+}
+
+ScopedSimSeed::~ScopedSimSeed() {
+    generator() = saved;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <random>
+
+// Random numbers for the simulation. Every thread has its own generator, so games stepped on
+// different threads (the simulation thread, evaluation scenarios) never race on shared state,
+// and a thread that is seeded replays the same run. Unseeded threads start from
+// std::random_device.
+constexpr int SIM_RAND_MAX = 0x7fffffff;
+
+void sim_srand(unsigned int seed);
+// Uniform in [0, SIM_RAND_MAX], a drop-in for rand()
+int sim_rand();
+// Uniform in [0, 1)
+float sim_rand_float();
+
+
+// Reseeds the calling thread's generator for the lifetime of the scope, then restores it. Work
+// items seeded this way give the same numbers on any thread, without disturbing the stream of
+// the thread that runs them.
+class ScopedSimSeed {
+public:
+    explicit ScopedSimSeed(unsigned int seed);
+    ~ScopedSimSeed();
+    ScopedSimSeed(const ScopedSimSeed&) = delete;
+    ScopedSimSeed& operator=(const ScopedSimSeed&) = delete;
+
+private:
+    std::mt19937 saved;
+};
@@ -0,0 +1,87 @@
+#include "RenderBatch.h"
+#include <cmath>
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+void RenderBatch::quad(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FPoint d, SDL_Color color) {
+    int base = static_cast<int>(vertices.size());
+    for (const SDL_FPoint& p : {a, b, c, d}) vertices.push_back({p, color, {0.0f, 0.0f}});
+    for (int i : {0, 1, 2, 0, 2, 3}) indices.push_back(base + i);
+}
+
+void RenderBatch::fill_rect(const SDL_Rect& rect, SDL_Color color) {
+    float x0 = float(rect.x), y0 = float(rect.y);
+    float x1 = x0 + rect.w, y1 = y0 + rect.h;
+    quad({x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}, color);
+    ++rects;
+}
+
+void RenderBatch::line(float x0, float y0, float x1, float y1, SDL_Color color) {
+    // A 1px wide quad along the segment
+    float dx = x1 - x0, dy = y1 - y0;
+    float len = std::sqrt(dx * dx + dy * dy);
+    float nx = 0.5f, ny = 0.0f;
+    if (len > 1e-4f) {
+        nx = -dy / len * 0.5f;
+        ny = dx / len * 0.5f;
+    }
+    quad({x0 + nx, y0 + ny}, {x1 + nx, y1 + ny}, {x1 - nx, y1 - ny}, {x0 - nx, y0 - ny}, color);
+    ++lines;
+}
+
+void RenderBatch::flush(SDL_Renderer* renderer) {
+    if (!indices.empty()) {
+        SDL_RenderGeometry(renderer, nullptr, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+    }
+    clear();
+}
+
+void RenderBatch::clear() {
+    vertices.clear();
+    indices.clear();
+    rects = 0;
+    lines = 0;
+}
+
+#else
+
+void RenderBatch::fill_rect(const SDL_Rect& rect, SDL_Color color) {
+    Uint32 key = (Uint32(color.r) << 24) | (Uint32(color.g) << 16) | (Uint32(color.b) << 8) | color.a;
+    auto [it, inserted] = group_of_color.emplace(key, rects_by_color.size());
+    if (inserted) rects_by_color.push_back({color, {}});
+    rects_by_color[it->second].rects.push_back(rect);
+    ++rects;
+}
+
+void RenderBatch::line(float x0, float y0, float x1, float y1, SDL_Color color) {
+    line_list.push_back({x0, y0, x1, y1, color});
+    ++lines;
+}
+
+void RenderBatch::flush(SDL_Renderer* renderer) {
+    for (const auto& group : rects_by_color) {
+        SDL_SetRenderDrawColor(renderer, group.color.r, group.color.g, group.color.b, group.color.a);
+        SDL_RenderFillRects(renderer, group.rects.data(), static_cast<int>(group.rects.size()));
+    }
+    bool have_color = false;
+    SDL_Color current = {0, 0, 0, 0};
+    for (const auto& l : line_list) {
+        if (!have_color || l.color.r != current.r || l.color.g != current.g || l.color.b != current.b || l.color.a != current.a) {
+            SDL_SetRenderDrawColor(renderer, l.color.r, l.color.g, l.color.b, l.color.a);
+            current = l.color;
+            have_color = true;
+        }
+        SDL_RenderDrawLine(renderer, int(l.x0), int(l.y0), int(l.x1), int(l.y1));
+    }
+    clear();
+}
+
+void RenderBatch::clear() {
+    rects_by_color.clear();
+    group_of_color.clear();
+    line_list.clear();
+    rects = 0;
+    lines = 0;
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+#include <SDL.h>
+#include <unordered_map>
+#include <vector>
+
+// Collects the entity rects and lines of a frame and submits them in as few calls as possible.
+// With SDL >= 2.0.18 everything becomes one SDL_RenderGeometry call with per-vertex colour
+// (lines are 1px quads), which keeps the draw order. Older SDL falls back to one
+// SDL_RenderFillRects call per colour and one SDL_RenderDrawLine per segment.
+class RenderBatch {
+public:
+    void fill_rect(const SDL_Rect& rect, SDL_Color color);
+    void line(float x0, float y0, float x1, float y1, SDL_Color color);
+    // Draws everything collected since the last flush, then clears the batch
+    void flush(SDL_Renderer* renderer);
+    void clear();
+    size_t rect_count() const { return rects; }
+    size_t line_count() const { return lines; }
+
+private:
+    size_t rects = 0;
+    size_t lines = 0;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    void quad(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FPoint d, SDL_Color color);
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+#else
+    struct ColorRects {
+        SDL_Color color;
+        std::vector<SDL_Rect> rects;
+    };
+    struct Line {
+        float x0, y0, x1, y1;
+        SDL_Color color;
+    };
+    std::vector<ColorRects> rects_by_color;
+    std::unordered_map<Uint32, size_t> group_of_color; // RGBA -> index in rects_by_color
+    std::vector<Line> line_list;
+#endif
+};
@@ -0,0 +1,380 @@
+#include "Replay.h"
+#include "Game.h"
+#include "Player.h"
+#include "Hunter.h"
+#include "Food.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    constexpr char MAGIC[4] = {'L', 'T', 'R', 'P'};
+    constexpr uint16_t VERSION = 1;
+    enum Kind : uint8_t { KIND_BOT = 0, KIND_HUMAN = 1, KIND_HUNTER = 2 };
+    enum MoveFlags : uint8_t { MOVE_POS = 1, MOVE_ANGLE = 2, MOVE_SPEED = 4, MOVE_SIZE = 8 };
+    constexpr float TWO_PI = 6.28318530718f;
+
+    uint16_t quantize(float v, int extent) {
+        float t = std::clamp(v / float(extent), 0.0f, 1.0f);
+        return static_cast<uint16_t>(std::lround(t * 65535.0f));
+    }
+    float dequantize(uint16_t q, int extent) { return q / 65535.0f * float(extent); }
+    uint8_t quantize_angle(float a) {
+        a = std::fmod(a, TWO_PI);
+        if (a < 0.0f) a += TWO_PI;
+        return static_cast<uint8_t>(std::lround(a / TWO_PI * 256.0f) & 0xff);
+    }
+    uint8_t quantize_speed(float s) { return static_cast<uint8_t>(std::lround(std::clamp(s / MAX_SPEED, 0.0f, 1.0f) * 255.0f)); }
+
+    void put_u8(std::vector<uint8_t>& out, uint8_t v) { out.push_back(v); }
+    void put_u16(std::vector<uint8_t>& out, uint16_t v) { out.push_back(v & 0xff); out.push_back(v >> 8); }
+    void put_u32(std::vector<uint8_t>& out, uint32_t v) { for (int i = 0; i < 4; ++i) out.push_back((v >> (8 * i)) & 0xff); }
+    void put_f32(std::vector<uint8_t>& out, float f) { uint32_t v; std::memcpy(&v, &f, 4); put_u32(out, v); }
+    void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+        while (v >= 0x80) { out.push_back(uint8_t(v) | 0x80); v >>= 7; }
+        out.push_back(uint8_t(v));
+    }
+    void put_zigzag(std::vector<uint8_t>& out, int64_t v) { put_varint(out, (uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    // Wrapping difference of two 16-bit positions, in [-32768, 32767]
+    int16_t wrap_delta(uint16_t to, uint16_t from) { return static_cast<int16_t>(uint16_t(to - from)); }
+
+    // Bounds-checked reading; after an overrun every read returns 0 and failed is set
+    struct Reader {
+        const uint8_t* p;
+        const uint8_t* end;
+        bool failed = false;
+        bool have(size_t n) { if (size_t(end - p) < n) failed = true; return !failed; }
+        uint8_t u8() { return have(1) ? *p++ : 0; }
+        uint16_t u16() { if (!have(2)) return 0; uint16_t v = uint16_t(p[0] | (p[1] << 8)); p += 2; return v; }
+        uint32_t u32() { if (!have(4)) return 0; uint32_t v = 0; for (int i = 0; i < 4; ++i) v |= uint32_t(p[i]) << (8 * i); p += 4; return v; }
+        float f32() { uint32_t v = u32(); float f; std::memcpy(&f, &v, 4); return f; }
+        uint64_t varint() {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64 && have(1); shift += 7) {
+                uint8_t b = *p++;
+                v |= uint64_t(b & 0x7f) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            failed = true;
+            return 0;
+        }
+        int64_t zigzag() { uint64_t v = varint(); return int64_t(v >> 1) ^ -int64_t(v & 1); }
+    };
+}
+
+ReplayRecorder::ReplayRecorder(const ReplayConfig& config_, int world_width_, int world_height_)
+    : config(config_), world_width(world_width_), world_height(world_height_), out(config_.path, std::ios::binary) {
+    config.interval = std::max(1, config.interval);
+    if (!out) {
+        std::cerr << "Cannot write replay " << config.path << std::endl;
+        return;
+    }
+    std::vector<uint8_t> header(MAGIC, MAGIC + 4);
+    put_u16(header, VERSION);
+    put_u32(header, uint32_t(world_width));
+    put_u32(header, uint32_t(world_height));
+    put_u16(header, uint16_t(std::min(config.interval, 65535)));
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    bytes += header.size();
+}
+
+void ReplayRecorder::on_tick(const Game& game, long long tick) {
+    if (tick % config.interval == 0) record(game, tick);
+}
+
+void ReplayRecorder::record(const Game& game, long long tick) {
+    if (!out) return;
+    const bool keyframe = frames % REPLAY_KEYFRAME_INTERVAL == 0;
+    if (keyframe) {
+        live.clear();
+        live_index.clear();
+        food_seen.clear();
+    }
+    payload.clear();
+    put_varint(payload, uint64_t(tick));
+    put_f32(payload, Player::display_best_fitness);
+    put_f32(payload, Player::display_avg_fitness);
+
+    // Match the alive players against the ones already recorded
+    for (auto& t : live) t.seen = false;
+    std::vector<Tracked> now(live.size());
+    std::vector<const Player*> spawned;
+    for (const auto* p : game.players) {
+        if (!p || !p->alive) continue;
+        Tracked t{p->uid, quantize(p->x, world_width), quantize(p->y, world_height), quantize_angle(p->angle), quantize_speed(p->speed), p->width, true};
+        auto it = live_index.find(p->uid);
+        if (it == live_index.end()) {
+            spawned.push_back(p);
+        } else {
+            now[it->second] = t;
+            live[it->second].seen = true;
+        }
+    }
+    // Deaths are swap-removed in the order written, exactly as playback does
+    std::vector<uint32_t> deaths;
+    for (const auto& t : live) if (!t.seen) deaths.push_back(t.uid);
+    put_varint(payload, deaths.size());
+    for (uint32_t uid : deaths) {
+        put_varint(payload, uid);
+        size_t i = live_index[uid];
+        live[i] = live.back();
+        now[i] = now.back();
+        live_index[live[i].uid] = i;
+        live.pop_back();
+        now.pop_back();
+        live_index.erase(uid);
+    }
+    put_varint(payload, live.size());
+    for (size_t i = 0; i < live.size(); ++i) {
+        Tracked& was = live[i];
+        const Tracked& is = now[i];
+        uint8_t flags = 0;
+        if (is.x != was.x || is.y != was.y) flags |= MOVE_POS;
+        if (is.angle != was.angle) flags |= MOVE_ANGLE;
+        if (is.speed != was.speed) flags |= MOVE_SPEED;
+        if (is.size != was.size) flags |= MOVE_SIZE;
+        put_u8(payload, flags);
+        if (flags & MOVE_POS) {
+            put_zigzag(payload, wrap_delta(is.x, was.x));
+            put_zigzag(payload, wrap_delta(is.y, was.y));
+        }
+        if (flags & MOVE_ANGLE) put_u8(payload, is.angle);
+        if (flags & MOVE_SPEED) put_u8(payload, is.speed);
+        if (flags & MOVE_SIZE) put_zigzag(payload, is.size - was.size);
+        was = is;
+    }
+    put_varint(payload, spawned.size());
+    for (const auto* p : spawned) {
+        uint8_t kind = p->is_human ? KIND_HUMAN : dynamic_cast<const Hunter*>(p) ? KIND_HUNTER : KIND_BOT;
+        Tracked t{p->uid, quantize(p->x, world_width), quantize(p->y, world_height), quantize_angle(p->angle), quantize_speed(p->speed), p->width, true};
+        put_varint(payload, t.uid);
+        put_u8(payload, kind);
+        put_u16(payload, t.x);
+        put_u16(payload, t.y);
+        put_u8(payload, t.angle);
+        put_u8(payload, t.speed);
+        put_varint(payload, uint32_t(p->width));
+        put_varint(payload, uint32_t(p->height));
+        put_u8(payload, p->color.r);
+        put_u8(payload, p->color.g);
+        put_u8(payload, p->color.b);
+        live_index[t.uid] = live.size();
+        live.push_back(t);
+    }
+
+    // Food only appears and disappears
+    for (auto& entry : food_seen) entry.second = false;
+    std::vector<const Food*> new_food;
+    for (const auto* f : game.foods) {
+        if (!f) continue;
+        auto it = food_seen.find(f->uid);
+        if (it == food_seen.end()) new_food.push_back(f);
+        else it->second = true;
+    }
+    std::vector<uint32_t> eaten;
+    for (const auto& entry : food_seen) if (!entry.second) eaten.push_back(entry.first);
+    put_varint(payload, eaten.size());
+    for (uint32_t uid : eaten) {
+        put_varint(payload, uid);
+        food_seen.erase(uid);
+    }
+    put_varint(payload, new_food.size());
+    for (const auto* f : new_food) {
+        put_varint(payload, f->uid);
+        put_u16(payload, quantize(f->x, world_width));
+        put_u16(payload, quantize(f->y, world_height));
+        put_varint(payload, uint32_t(f->width));
+        food_seen[f->uid] = true;
+    }
+
+    std::vector<uint8_t> frame_header;
+    put_u8(frame_header, keyframe ? 'K' : 'D');
+    put_u32(frame_header, uint32_t(payload.size()));
+    out.write(reinterpret_cast<const char*>(frame_header.data()), frame_header.size());
+    out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    bytes += frame_header.size() + payload.size();
+    ++frames;
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open replay " << path << std::endl;
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    frames.clear();
+    Reader header{data.data(), data.data() + data.size()};
+    bool magic_ok = header.have(4) && std::memcmp(data.data(), MAGIC, 4) == 0;
+    header.p += magic_ok ? 4 : 0;
+    uint16_t version = header.u16();
+    width = int(header.u32());
+    height = int(header.u32());
+    header.u16(); // record interval, informational
+    if (!magic_ok || header.failed || version != VERSION || width <= 0 || height <= 0) {
+        std::cerr << path << " is not a replay recording (or an unsupported version)" << std::endl;
+        return false;
+    }
+    // Index the frames so seeking never has to scan
+    Reader r{header.p, data.data() + data.size()};
+    while (r.p < r.end) {
+        uint8_t type = r.u8();
+        uint32_t bytes = r.u32();
+        if (r.failed || (type != 'K' && type != 'D') || !r.have(bytes)) break; // truncated tail
+        Reader payload{r.p, r.p + bytes};
+        long long tick = (long long)payload.varint();
+        frames.push_back({size_t(r.p - data.data()), bytes, tick, type == 'K'});
+        r.p += bytes;
+    }
+    if (frames.empty() || !frames.front().keyframe) {
+        std::cerr << path << " holds no frames" << std::endl;
+        return false;
+    }
+    decoded_any = false;
+    seek(0);
+    return true;
+}
+
+void ReplayPlayer::decode(size_t frame) {
+    const FrameInfo& info = frames[frame];
+    Reader r{data.data() + info.offset, data.data() + info.offset + info.bytes};
+    if (info.keyframe) {
+        live.clear();
+        live_index.clear();
+        foods.clear();
+        food_index.clear();
+    }
+    r.varint(); // tick, already indexed
+    best_fitness = r.f32();
+    avg_fitness = r.f32();
+    for (uint64_t n = r.varint(); n > 0 && !r.failed; --n) {
+        auto it = live_index.find(uint32_t(r.varint()));
+        if (it == live_index.end()) continue;
+        size_t i = it->second;
+        live_index.erase(it);
+        live[i] = live.back();
+        live.pop_back();
+        if (i < live.size()) live_index[live[i].uid] = i;
+    }
+    uint64_t moves = r.varint();
+    for (size_t i = 0; i < moves && i < live.size() && !r.failed; ++i) {
+        Entity& e = live[i];
+        uint8_t flags = r.u8();
+        if (flags & MOVE_POS) {
+            e.x = uint16_t(e.x + int(r.zigzag()));
+            e.y = uint16_t(e.y + int(r.zigzag()));
+        }
+        if (flags & MOVE_ANGLE) e.angle = r.u8();
+        if (flags & MOVE_SPEED) e.speed = r.u8();
+        if (flags & MOVE_SIZE) {
+            int delta = int(r.zigzag());
+            e.width += delta;
+            e.height += delta;
+        }
+    }
+    for (uint64_t n = r.varint(); n > 0 && !r.failed; --n) {
+        Entity e;
+        e.uid = uint32_t(r.varint());
+        e.kind = r.u8();
+        e.x = r.u16();
+        e.y = r.u16();
+        e.angle = r.u8();
+        e.speed = r.u8();
+        e.width = int(r.varint());
+        e.height = int(r.varint());
+        e.color.r = r.u8();
+        e.color.g = r.u8();
+        e.color.b = r.u8();
+        e.color.a = 255;
+        live_index[e.uid] = live.size();
+        live.push_back(e);
+    }
+    for (uint64_t n = r.varint(); n > 0 && !r.failed; --n) {
+        auto it = food_index.find(uint32_t(r.varint()));
+        if (it == food_index.end()) continue;
+        size_t i = it->second;
+        food_index.erase(it);
+        foods[i] = foods.back();
+        foods.pop_back();
+        if (i < foods.size()) food_index[foods[i].uid] = i;
+    }
+    for (uint64_t n = r.varint(); n > 0 && !r.failed; --n) {
+        FoodItem f;
+        f.uid = uint32_t(r.varint());
+        f.x = r.u16();
+        f.y = r.u16();
+        f.size = int(r.varint());
+        food_index[f.uid] = foods.size();
+        foods.push_back(f);
+    }
+    if (r.failed) std::cerr << "Replay frame " << frame << " is corrupt" << std::endl;
+}
+
+void ReplayPlayer::seek(size_t target) {
+    if (frames.empty()) return;
+    target = std::min(target, frames.size() - 1);
+    if (decoded_any && target == current) return;
+    size_t key = target;
+    while (key > 0 && !frames[key].keyframe) --key;
+    // Decode forwards from the current frame when no keyframe lies in between
+    size_t from = (decoded_any && current >= key && current < target) ? current + 1 : key;
+    for (size_t f = from; f <= target; ++f) decode(f);
+    current = target;
+    decoded_any = true;
+}
+
+void ReplayPlayer::seek_tick(long long tick) {
+    auto it = std::upper_bound(frames.begin(), frames.end(), tick, [](long long t, const FrameInfo& f) { return t < f.tick; });
+    seek(it == frames.begin() ? 0 : size_t(it - frames.begin()) - 1);
+}
+
+void ReplayPlayer::fill_snapshot(RenderSnapshot& snapshot) const {
+    using SnapKind = RenderSnapshot::Kind;
+    snapshot.entities.clear();
+    snapshot.top_bots.clear();
+    snapshot.world_width = width;
+    snapshot.world_height = height;
+    snapshot.has_human = false;
+    snapshot.total_hunters = 0;
+    auto add = [&](const Entity& e, SnapKind kind) {
+        float x = dequantize(e.x, width), y = dequantize(e.y, height);
+        float angle = e.angle / 256.0f * TWO_PI;
+        float speed = e.speed / 255.0f * MAX_SPEED;
+        snapshot.entities.push_back({x, y, x, y, e.width, e.height, e.color, angle, speed, kind});
+    };
+    // Same draw order as a live game: bots, hunters, food
+    for (const auto& e : live) {
+        if (e.kind == KIND_HUNTER) continue;
+        add(e, e.kind == KIND_HUMAN ? SnapKind::Human : SnapKind::Bot);
+        if (e.kind == KIND_HUMAN) {
+            snapshot.has_human = true;
+            snapshot.human = {e.color, e.width, 0, 0};
+        }
+    }
+    for (const auto& e : live) {
+        if (e.kind != KIND_HUNTER) continue;
+        add(e, SnapKind::Hunter);
+        snapshot.entities.back().color = {255, 0, 0, 255};
+        ++snapshot.total_hunters;
+    }
+    for (const auto& f : foods) {
+        float x = dequantize(f.x, width), y = dequantize(f.y, height);
+        snapshot.entities.push_back({x, y, x, y, f.size, f.size, {0, 255, 0, 255}, 0.0f, 0.0f, SnapKind::Food});
+    }
+    snapshot.alive_players = int(live.size());
+    snapshot.total_food = int(foods.size());
+    snapshot.ticks = tick();
+    snapshot.game_time_units = int(tick());
+    snapshot.best_fitness = best_fitness;
+    snapshot.avg_fitness = avg_fitness;
+    snapshot.last_fitness = 0.0f;
+    snapshot.avg_diversity = 0.0f;
+    snapshot.mutation_rate = 0.0f;
+    snapshot.paused = true; // nothing to interpolate
+    snapshot.tick_seconds = 0.0;
+    snapshot.ticks_per_second = 0.0;
+    snapshot.target_tps = 0.0;
+}
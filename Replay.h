@@ -0,0 +1,107 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Settings.h"
+class Game;
+struct RenderSnapshot;
+
+struct ReplayConfig {
+    std::string path;                      // empty = not recording
+    int interval = REPLAY_RECORD_INTERVAL; // ticks between recorded frames
+};
+
+// Replay file format (little-endian):
+//   header: "LTRP", u16 version, u32 world width, u32 world height, u16 record interval
+//   frames: u8 type ('K' keyframe, 'D' delta), u32 payload bytes, payload
+// Payload: varint tick, f32 best and avg fitness, then
+//   player deaths (varint count, varint uids)
+//   moves of the surviving players, in the order both sides keep them: u8 flags, then the
+//     changed fields (zigzag varint dx and dy, u8 angle, u8 speed, zigzag varint size delta)
+//   player spawns (varint count; varint uid, u8 kind, u16 x, u16 y, u8 angle, u8 speed,
+//     varint width, varint height, u8 r, g, b)
+//   food removals (varint count, varint uids), food spawns (varint uid, u16 x, u16 y, varint size)
+// Positions are 16-bit fixed point across the world; moves are deltas modulo 2^16. A
+// keyframe lists everything as spawns, so playback can seek by decoding from the nearest one.
+
+class ReplayRecorder {
+public:
+    ReplayRecorder(const ReplayConfig& config, int world_width, int world_height);
+    bool ok() const { return out.good(); }
+    // Records a frame every config.interval ticks
+    void on_tick(const Game& game, long long tick);
+    void record(const Game& game, long long tick);
+    size_t bytes_written() const { return bytes; }
+
+private:
+    struct Tracked {
+        uint32_t uid;
+        uint16_t x, y;
+        uint8_t angle, speed;
+        int size;
+        bool seen;
+    };
+    ReplayConfig config;
+    int world_width, world_height;
+    std::ofstream out;
+    size_t bytes = 0;
+    long long frames = 0;
+    std::vector<Tracked> live;                       // recording order of the alive players
+    std::unordered_map<uint32_t, size_t> live_index; // uid -> index in live
+    std::unordered_map<uint32_t, bool> food_seen;    // uid -> seen this frame
+    std::vector<uint8_t> payload;                    // scratch
+};
+
+class ReplayPlayer {
+public:
+    // Reads and indexes a whole recording; false (with a message) if it is not one
+    bool load(const std::string& path);
+    size_t frame_count() const { return frames.size(); }
+    size_t frame() const { return current; }
+    long long tick() const { return frames.empty() ? 0 : frames[current].tick; }
+    long long first_tick() const { return frames.empty() ? 0 : frames.front().tick; }
+    long long last_tick() const { return frames.empty() ? 0 : frames.back().tick; }
+    int world_width() const { return width; }
+    int world_height() const { return height; }
+    // Moves to a frame, decoding forwards from the closest keyframe when needed
+    void seek(size_t frame);
+    // Moves to the last frame at or before tick
+    void seek_tick(long long tick);
+    void fill_snapshot(RenderSnapshot& snapshot) const;
+
+private:
+    struct FrameInfo {
+        size_t offset; // of the payload
+        uint32_t bytes;
+        long long tick;
+        bool keyframe;
+    };
+    struct Entity {
+        uint32_t uid;
+        uint8_t kind;
+        uint16_t x, y;
+        uint8_t angle, speed;
+        int width, height;
+        SDL_Color color;
+    };
+    struct FoodItem {
+        uint32_t uid;
+        uint16_t x, y;
+        int size;
+    };
+    void decode(size_t frame);
+
+    std::vector<uint8_t> data;
+    std::vector<FrameInfo> frames;
+    int width = SCREEN_WIDTH, height = SCREEN_HEIGHT;
+    size_t current = 0;
+    bool decoded_any = false;
+    float best_fitness = 0.0f, avg_fitness = 0.0f;
+    std::vector<Entity> live;
+    std::unordered_map<uint32_t, size_t> live_index;
+    std::vector<FoodItem> foods;
+    std::unordered_map<uint32_t, size_t> food_index;
+};
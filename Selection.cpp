@@ -0,0 +1,136 @@
+#include "Selection.h"
+#include "Random.h"
+#include <algorithm>
+#include <array>
+
+SelectionMethod g_selection = SelectionMethod::Tournament;
+
+const char* selection_method_name(SelectionMethod method) {
+    switch (method) {
+        case SelectionMethod::Proportional: return "proportional";
+        case SelectionMethod::Rank: return "rank";
+        default: return "tournament";
+    }
+}
+
+bool parse_selection_method(const std::string& text, SelectionMethod& method) {
+    if (text == "tournament") method = SelectionMethod::Tournament;
+    else if (text == "proportional") method = SelectionMethod::Proportional;
+    else if (text == "rank") method = SelectionMethod::Rank;
+    else return false;
+    return true;
+}
+
+void ParentSampler::AliasTable::build(std::vector<double>& weights, std::vector<int>& small, std::vector<int>& large) {
+    const int n = int(weights.size());
+    prob.assign(n, 1.0f);
+    alias.resize(n);
+    double sum = 0.0;
+    for (double w : weights) sum += w;
+    if (n == 0 || sum <= 0.0) {
+        for (int i = 0; i < n; ++i) alias[i] = i;
+        return;
+    }
+    // Vose: columns below the mean are topped up from one column above it
+    std::vector<double>& scaled = weights;
+    small.clear();
+    large.clear();
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * n / sum;
+        alias[i] = i;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back(), l = large.back();
+        small.pop_back();
+        prob[s] = float(scaled[s]);
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // What is left is 1 up to rounding
+}
+
+int ParentSampler::AliasTable::sample() const {
+    if (prob.empty()) return -1;
+    int i = sim_rand() % int(prob.size());
+    return sim_rand_float() < prob[i] ? i : alias[i];
+}
+
+void ParentSampler::sync(const std::vector<Player::GeneEntry>& pool, uint64_t pool_version) {
+    // The size check also catches writers that forgot to bump the version
+    if (pool_version == version && pool.size() == fitness.size()) return;
+    version = pool_version;
+    ++rebuilds;
+    const int n = int(pool.size());
+    fitness.resize(n);
+    float lo = 0.0f, hi = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        fitness[i] = pool[i].fitness;
+        lo = i == 0 ? fitness[i] : std::min(lo, fitness[i]);
+        hi = i == 0 ? fitness[i] : std::max(hi, fitness[i]);
+    }
+    // Fitness-proportional, shifted above zero; equal fitness gives a uniform table
+    const double floor = std::max(1e-6, 0.01 * (double(hi) - double(lo)));
+    weights.resize(n);
+    for (int i = 0; i < n; ++i) weights[i] = double(fitness[i]) - lo + floor;
+    by_fitness.build(weights, small, large);
+    // Linear ranking: the best gets s times the mean weight, the worst 2 - s
+    order.resize(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return fitness[a] > fitness[b]; });
+    const double s = RANK_SELECTION_PRESSURE;
+    for (int r = 0; r < n; ++r) {
+        weights[order[r]] = n > 1 ? (2.0 - s) + 2.0 * (s - 1.0) * double(n - 1 - r) / double(n - 1) : 1.0;
+    }
+    by_rank.build(weights, small, large);
+}
+
+std::pair<int, int> ParentSampler::tournament(int k) const {
+    const int n = int(fitness.size());
+    k = std::clamp(k, 2, MAX_TOURNAMENT);
+    std::array<int, MAX_TOURNAMENT> drawn;
+    int count = 0;
+    while (count < k && count < n) {
+        int idx = sim_rand() % n;
+        if (std::find(drawn.begin(), drawn.begin() + count, idx) == drawn.begin() + count) drawn[count++] = idx;
+    }
+    if (count < 2) return {count == 1 ? drawn[0] : -1, -1};
+    // The fittest two, earlier draws winning ties
+    int best = -1, second = -1;
+    for (int i = 0; i < count; ++i) {
+        int idx = drawn[i];
+        if (best < 0 || fitness[idx] > fitness[best]) { second = best; best = idx; }
+        else if (second < 0 || fitness[idx] > fitness[second]) second = idx;
+    }
+    return {best, second};
+}
+
+template <typename Draw>
+int ParentSampler::distinct_from(int first, Draw&& draw) const {
+    // With two or more entries a few redraws almost always differ; then take a neighbour
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        int idx = draw();
+        if (idx != first) return idx;
+    }
+    return (first + 1) % int(fitness.size());
+}
+
+std::pair<int, int> ParentSampler::parents(SelectionMethod method, int tournament_size) const {
+    if (fitness.size() < 2) return {fitness.empty() ? -1 : 0, -1};
+    switch (method) {
+        case SelectionMethod::Proportional: {
+            int first = proportional();
+            return {first, distinct_from(first, [&]() { return proportional(); })};
+        }
+        case SelectionMethod::Rank: {
+            int first = rank();
+            return {first, distinct_from(first, [&]() { return rank(); })};
+        }
+        default:
+            return tournament(tournament_size);
+    }
+}
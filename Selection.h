@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Player.h"
+
+// How maintain_population picks the two parents of a crossover child (--selection)
+enum class SelectionMethod { Tournament, Proportional, Rank };
+extern SelectionMethod g_selection;
+const char* selection_method_name(SelectionMethod method);
+bool parse_selection_method(const std::string& text, SelectionMethod& method);
+
+// Parent samplers over a gene pool. The tables are rebuilt by sync() only when the pool's
+// version (Player::gene_pool_version) or size changed, so a refill of dozens of children pays
+// for one build. Every draw returns pool indices and allocates nothing:
+//   proportional: Vose alias table over the fitness, shifted so the least fit entry keeps a
+//                 small weight (fitness can be negative); O(1) per draw
+//   rank:         alias table over linear ranking weights with RANK_SELECTION_PRESSURE; O(1)
+//   tournament:   the two fittest of up to k distinct uniform draws; O(k^2) with k small
+class ParentSampler {
+public:
+    static constexpr int MAX_TOURNAMENT = 16;
+
+    void sync(const std::vector<Player::GeneEntry>& pool, uint64_t pool_version);
+    size_t size() const { return fitness.size(); }
+    int proportional() const { return by_fitness.sample(); }
+    int rank() const { return by_rank.sample(); }
+    // second is -1 when the pool has fewer than two entries
+    std::pair<int, int> tournament(int k) const;
+    // Two distinct parents, or second = -1 when the pool has fewer than two entries
+    std::pair<int, int> parents(SelectionMethod method, int tournament_size) const;
+    long long rebuilds = 0;
+
+private:
+    struct AliasTable {
+        std::vector<float> prob; // chance of keeping column i rather than taking alias[i]
+        std::vector<int> alias;
+        // Scales weights in place
+        void build(std::vector<double>& weights, std::vector<int>& small, std::vector<int>& large);
+        int sample() const;
+    };
+    // A second draw distinct from first
+    template <typename Draw>
+    int distinct_from(int first, Draw&& draw) const;
+
+    AliasTable by_fitness, by_rank;
+    std::vector<float> fitness; // of each pool entry when the tables were built
+    uint64_t version = UINT64_MAX;
+    // Build scratch
+    std::vector<double> weights;
+    std::vector<int> order, small, large;
+};
@@ -0,0 +1,205 @@
+#include "Sensing.h"
+#include "Game.h"
+#include "Player.h"
+#include "Food.h"
+#include "FastMath.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+void sensor_inputs(const SensorRows& rows, int n, float world_width, float world_height, float* out) {
+    constexpr float PI = 3.14159265358979f;
+    constexpr float TWO_PI = 2.0f * PI;
+    constexpr float INV_PI = 1.0f / PI;
+    // Multiplies by reciprocals: divides are the slowest vector ops here
+    const float inv_diag = 1.0f / std::sqrt(world_width * world_width + world_height * world_height);
+    const float inv_width = 1.0f / world_width, inv_height = 1.0f / world_height;
+    // Local copies of the row pointers: the stores to out could otherwise alias rows itself
+    const float *food_dist = rows.food_dist, *to_food_angle = rows.to_food_angle, *player_dist = rows.player_dist;
+    const float *to_player_angle = rows.to_player_angle, *neighbour_width = rows.neighbour_width;
+    const float *xs = rows.x, *ys = rows.y, *widths = rows.width, *heights = rows.height;
+    const float *angle = rows.angle, *speed = rows.speed, *food_count = rows.food_count;
+    #pragma omp simd
+    for (int i = 0; i < n; ++i) {
+        const float x = xs[i], y = ys[i], width = widths[i], height = heights[i];
+        // Relative angles are in [-3pi, pi): one wrap step each way is enough
+        float rel_food = to_food_angle[i] - angle[i];
+        rel_food += rel_food < -PI ? TWO_PI : 0.0f;
+        rel_food -= rel_food > PI ? TWO_PI : 0.0f;
+        float rel_player = to_player_angle[i] - angle[i];
+        rel_player += rel_player < -PI ? TWO_PI : 0.0f;
+        rel_player -= rel_player > PI ? TWO_PI : 0.0f;
+        float size_diff = (width - neighbour_width[i]) * (1.0f / DOT_WIDTH); // positive: bigger
+        size_diff = size_diff < -1.0f ? -1.0f : size_diff;
+        size_diff = size_diff > 1.0f ? 1.0f : size_diff;
+        float own_food = food_count[i] * (1.0f / 50.0f); // clipped after 50
+        own_food = own_food > 1.0f ? 1.0f : own_food;
+        // Everything mapped to [-1, 1], then scaled
+        out[0 * n + i] = (food_dist[i] * inv_diag * 2.0f - 1.0f) * SCALE_FOOD_DIST;
+        out[1 * n + i] = rel_food * INV_PI * SCALE_FOOD_ANGLE;
+        out[2 * n + i] = (player_dist[i] * inv_diag * 2.0f - 1.0f) * SCALE_PLAYER_DIST;
+        out[3 * n + i] = rel_player * INV_PI * SCALE_PLAYER_ANGLE;
+        out[4 * n + i] = (x * inv_width * 2.0f - 1.0f) * SCALE_WALL;
+        out[5 * n + i] = ((world_width - (x + width)) * inv_width * 2.0f - 1.0f) * SCALE_WALL;
+        out[6 * n + i] = (y * inv_height * 2.0f - 1.0f) * SCALE_WALL;
+        out[7 * n + i] = ((world_height - (y + height)) * inv_height * 2.0f - 1.0f) * SCALE_WALL;
+        out[8 * n + i] = (speed[i] * (1.0f / MAX_SPEED) * 2.0f - 1.0f) * SCALE_SPEED;
+        out[9 * n + i] = size_diff * SCALE_SIZE_DIFF;
+        out[10 * n + i] = (width * (1.0f / MAX_PLAYER_SIZE) * 2.0f - 1.0f) * SCALE_OWN_SIZE;
+        out[11 * n + i] = (own_food * 2.0f - 1.0f) * SCALE_OWN_FOOD;
+    }
+}
+
+namespace {
+    constexpr float BOUND_MARGIN = 1e-2f; // absorbs float rounding in the lazy sensing bounds
+    constexpr double QUERY_WORK = 400.0; // float ops of one agent's nearest queries, for the thread pool
+    constexpr uint8_t REUSED_FOOD = 1, REUSED_PLAYER = 2;
+}
+
+void SensorBatch::sense(Game& game) {
+    // The alive players in grid cell order: neighbouring agents run their nearest queries over
+    // the same cells one after the other. The grid was rebuilt at the start of this tick.
+    agents.clear();
+    for (auto* p : game.player_grid.items_by_cell()) {
+        if (p && p->alive) agents.push_back(p);
+    }
+    const int n = int(agents.size());
+    for (auto* row : {&food_dist, &to_food_angle, &player_dist, &to_player_angle, &neighbour_width,
+                      &x, &y, &width, &height, &angle, &speed, &food_count}) {
+        row->resize(n);
+    }
+    raw.resize(size_t(n) * NN_INPUTS);
+    state.resize(size_t(n) * NN_INPUTS);
+
+    // Match the agents to the previous pass, and find how far any of them moved or grew since
+    ++pass;
+    previous_slot.assign(previous_count, -1);
+    fresh.clear();
+    float drift = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        Player* p = agents[i];
+        const SensorCache& cache = p->sensor_cache;
+        if (cache.pass == pass - 1 && p->sensor_slot >= 0 && p->sensor_slot < previous_count) {
+            previous_slot[p->sensor_slot] = i;
+            const float radius = (p->width + p->height) / 4.0f;
+            drift = std::max(drift, std::hypot(p->x - cache.x, p->y - cache.y) + std::max(0.0f, radius - cache.radius));
+        } else {
+            fresh.push_back(i);
+        }
+        p->sensor_slot = i;
+    }
+    const bool players_lazy = lazy && int(fresh.size()) <= LAZY_SENSING_MAX_NEW_AGENTS;
+
+    // Queries and state, per agent on the thread pool: an agent only writes its own cache and
+    // slot i of the rows, and reads what the matching pass above left
+    reused.assign(n, 0);
+    ThreadPool::shared().parallel_for(size_t(n), QUERY_WORK, [&, n, drift, players_lazy](size_t begin, size_t end) {
+        for (int i = int(begin); i < int(end); ++i) {
+            Player* p = agents[i];
+            SensorCache& cache = p->sensor_cache;
+            const float radius = (p->width + p->height) / 4.0f;
+            const bool continuing = cache.pass == pass - 1;
+            const float moved = continuing ? std::hypot(p->x - cache.x, p->y - cache.y) : 0.0f;
+            const float grown = continuing ? std::max(0.0f, radius - cache.radius) : 0.0f;
+
+            float dist = 1e6f, dx = 0.0f, dy = 0.0f;
+            const Food* food = nullptr;
+            if (lazy && continuing && cache.food) {
+                float bound = cache.food_bound - moved;
+                for (const auto& event : game.food_events) {
+                    if (event.spawned) bound = std::min(bound, std::hypot(event.x - p->x, event.y - p->y));
+                    else if (event.uid == cache.food_uid) { bound = -1.0f; break; }
+                }
+                // Not eaten, so the pointer is still live
+                const float d = bound > 0.0f ? Game::food_distance(p->x, p->y, *cache.food) : 0.0f;
+                if (bound > 0.0f && d < bound - BOUND_MARGIN && d < dist) {
+                    food = cache.food;
+                    dist = d;
+                    cache.food_bound = bound;
+                    reused[i] |= REUSED_FOOD;
+                }
+            }
+            if (!food) {
+                food = game.nearest_food(p->x, p->y, dist, &cache.food_bound);
+                cache.food = food;
+                cache.food_uid = food ? food->uid : 0;
+            }
+            if (food) {
+                dx = food->x - p->x;
+                dy = food->y - p->y;
+            }
+            food_dist[i] = dist;
+            to_food_angle[i] = sim_atan2(dy, dx);
+
+            dist = 1e6f;
+            dx = dy = 0.0f;
+            const Player* other = nullptr;
+            if (players_lazy && continuing && cache.player_slot >= 0 && cache.player_slot < previous_count && previous_slot[cache.player_slot] >= 0) {
+                const Player* q = agents[previous_slot[cache.player_slot]];
+                float bound = cache.player_bound - moved - grown - drift;
+                for (int f : fresh) {
+                    if (agents[f] != p) bound = std::min(bound, Game::edge_distance(*p, *agents[f]));
+                }
+                const float d = Game::edge_distance(*p, *q);
+                if (q != p && d < bound - BOUND_MARGIN && d < dist) {
+                    other = q;
+                    dist = d;
+                    cache.player_bound = bound;
+                    reused[i] |= REUSED_PLAYER;
+                }
+            }
+            if (!other) other = game.nearest_player(*p, dist, &cache.player_bound);
+            cache.player_slot = other && other->sensor_slot >= 0 && other->sensor_slot < n && agents[other->sensor_slot] == other ? other->sensor_slot : -1;
+            int other_width = DOT_WIDTH;
+            if (other) {
+                dx = other->x - p->x;
+                dy = other->y - p->y;
+                other_width = other->width;
+            }
+            player_dist[i] = dist;
+            to_player_angle[i] = sim_atan2(dy, dx);
+            neighbour_width[i] = float(other_width);
+
+            cache.pass = pass;
+            cache.x = p->x;
+            cache.y = p->y;
+            cache.radius = radius;
+            x[i] = p->x;
+            y[i] = p->y;
+            width[i] = float(p->width);
+            height[i] = float(p->height);
+            angle[i] = p->angle;
+            speed[i] = p->speed;
+            food_count[i] = float(p->foodCount);
+            for (int k = 0; k < NN_INPUTS; ++k) state[size_t(k) * n + i] = p->smoothed_inputs[k];
+        }
+    });
+    for (uint8_t r : reused) {
+        food_reused += (r & REUSED_FOOD) != 0;
+        players_reused += (r & REUSED_PLAYER) != 0;
+    }
+    sensed += n;
+    previous_count = n;
+    game.food_events.clear();
+
+    // Input math across agents
+    SensorRows rows{food_dist.data(), to_food_angle.data(), player_dist.data(), to_player_angle.data(), neighbour_width.data(),
+                    x.data(), y.data(), width.data(), height.data(), angle.data(), speed.data(), food_count.data()};
+    sensor_inputs(rows, n, float(game.width), float(game.height), raw.data());
+    smooth_inputs(state.data(), raw.data(), n * NN_INPUTS);
+
+    for (int i = 0; i < n; ++i) {
+        for (int k = 0; k < NN_INPUTS; ++k) agents[i]->smoothed_inputs[k] = state[size_t(k) * n + i];
+    }
+}
+
+bool SensorBatch::take(const Player& p, std::array<float, NN_INPUTS>& inputs) const {
+    if (p.sensor_slot < 0 || p.sensor_slot >= int(agents.size()) || agents[p.sensor_slot] != &p) return false;
+    inputs = p.smoothed_inputs;
+    return true;
+}
+
+bool SensorBatch::isolated(const Player& p, float radius) const {
+    if (p.sensor_slot < 0 || p.sensor_slot >= int(agents.size()) || agents[p.sensor_slot] != &p) return false;
+    return food_dist[p.sensor_slot] > radius && player_dist[p.sensor_slot] > radius;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Settings.h"
+class Game;
+class Player;
+class Food;
+
+// Per-agent values the inputs are computed from, one array (row) per value
+struct SensorRows {
+    const float* food_dist;       // centre distance to the nearest food (1e6 if none)
+    const float* to_food_angle;   // world angle towards it
+    const float* player_dist;     // edge distance to the nearest other player (1e6 if none)
+    const float* to_player_angle;
+    const float* neighbour_width; // width of that player (DOT_WIDTH if none)
+    const float* x;
+    const float* y;
+    const float* width;
+    const float* height;
+    const float* angle;           // in [0, 2*pi) (apply_nn_output keeps it there)
+    const float* speed;
+    const float* food_count;
+};
+
+// Scaled network inputs of n agents before smoothing; input k of agent i goes to out[k * n + i].
+// Straight-line float math that vectorises across agents; the scalar path passes n = 1.
+void sensor_inputs(const SensorRows& rows, int n, float world_width, float world_height, float* out);
+static_assert(NN_INPUTS == 12, "sensor_inputs writes twelve inputs");
+
+// Low-pass filter of the inputs: state = alpha * input + (1 - alpha) * state, over n floats
+inline void smooth_inputs(float* state, const float* input, int n) {
+    const float alpha = NN_INPUT_SMOOTHING_ALPHA;
+    #pragma omp simd
+    for (int i = 0; i < n; ++i) state[i] = alpha * input[i] + (1.0f - alpha) * state[i];
+}
+
+// What an agent's last sensing pass found, kept so the next pass can skip the nearest queries
+// (LAZY_SENSING). Each bound is a lower bound on the distance of every other candidate, kept
+// current pass by pass:
+//   food:   food never moves, so the bound shrinks by the agent's own movement, and to the
+//           distance of any food spawned since; the cached food being eaten drops it
+//   player: the bound also shrinks by the agent's own growth and by the largest movement plus
+//           growth of any agent in the pass, and to the distance of agents new to the pass
+// While the cached answer is strictly closer than its bound it is still the exact nearest.
+struct SensorCache {
+    int64_t pass = -1;          // SensorBatch pass of the values below
+    float x = 0.0f, y = 0.0f;   // position and radius then
+    float radius = 0.0f;
+    const Food* food = nullptr; // nearest food, valid while no event removed food_uid
+    uint32_t food_uid = 0;
+    float food_bound = 0.0f;
+    int player_slot = -1;       // nearest player, as its slot in that pass
+    float player_bound = 0.0f;
+};
+
+// Senses every alive player at once at the start of the player phase (BATCHED_SENSING).
+// The nearest-neighbour queries run per agent; the input math and the smoothing then run
+// over structure-of-arrays rows, one row per input, so they vectorise across agents. The
+// queries of a large batch are spread over the thread pool (ThreadPool.h).
+// All agents sense the world as it was when the tick started, rather than after the
+// players before them in the update order have moved and eaten.
+class SensorBatch {
+public:
+    // Senses the alive players of the grid (rebuilt this tick), smoothing their inputs in place
+    void sense(Game& game);
+    // The smoothed inputs of p from this tick's batch; false if p was not in it
+    bool take(const Player& p, std::array<float, NN_INPUTS>& inputs) const;
+    // True if p was in this tick's batch with no food and no other player within radius
+    bool isolated(const Player& p, float radius) const;
+    void clear() { agents.clear(); }
+    size_t size() const { return agents.size(); }
+    bool lazy = LAZY_SENSING; // reuse still-valid nearest answers (see SensorCache)
+    // Since construction: agents sensed, and how many of those reused each cached answer
+    long long sensed = 0, food_reused = 0, players_reused = 0;
+
+private:
+    std::vector<Player*> agents;
+    int64_t pass = 0;
+    int previous_count = 0;          // agents in the previous pass
+    std::vector<int> previous_slot;  // slot in this pass of each agent of the previous pass, or -1
+    std::vector<int> fresh;          // slots of agents that were not in the previous pass
+    std::vector<uint8_t> reused;     // per agent: which cached answers it reused this pass
+    // Gathered per agent
+    std::vector<float> food_dist, to_food_angle, player_dist, to_player_angle, neighbour_width;
+    std::vector<float> x, y, width, height, angle, speed, food_count;
+    // NN_INPUTS rows of agents.size(): raw inputs and the smoothed state
+    std::vector<float> raw, state;
+};
@@ -75,6 +75,19 @@ constexpr float SCALE_OWN_SIZE = 8.0f;
 
 // Smoothing factor for temporal smoothing of NN inputs
 constexpr float NN_INPUT_SMOOTHING_ALPHA = 0.2f;
+// Sense all agents in one vectorised pass at the start of the player phase (see Sensing.h);
+// false senses each agent inside its own update, after the agents before it have moved
+constexpr bool BATCHED_SENSING = true;
+// Reuse each agent's nearest food / player from the previous pass while a distance bound
+// proves it unchanged (see SensorCache in Sensing.h)
+constexpr bool LAZY_SENSING = true;
+constexpr int LAZY_SENSING_MAX_NEW_AGENTS = 16; // with more new agents in a pass, all nearest players are re-queried
+// Level-of-detail scheduling: a bot with no food and no player or hunter within LOD_RADIUS
+// keeps its last steering and runs its network only every LOD_INTERVAL ticks, moving in
+// between; bots near anything run at full rate. Needs BATCHED_SENSING (--lod K at runtime)
+constexpr bool LOD_SCHEDULING = false;
+constexpr float LOD_RADIUS = 150.0f;
+constexpr int LOD_INTERVAL = 4;
 
 // Spatial Partitioning
 constexpr int GRID_CELL_SIZE = MAX_PLAYER_SIZE / 4;
@@ -86,6 +99,9 @@ constexpr float MUTATION_RATE = 0.1f;
 constexpr int MUTATION_ATTEMPTS = 10;
 constexpr float MUTATION_MAGNITUDE = 0.1f;
 constexpr float LARGE_MUTATION_PROB = 0.05f;
+// Linear rank selection (--selection rank): the best gene pool entry is drawn this many times
+// as often as the mean, the worst 2 - this; in [1, 2]
+constexpr float RANK_SELECTION_PRESSURE = 1.5f;
 constexpr float LARGE_MUTATION_SCALE = 5.0f;
 constexpr int ADAPTIVE_MUTATION_PATIENCE = 1; // check for improvement in GENE_POOL_CHECK_INTERVAL's
 constexpr float MAX_MUTATION_RATE = 1.0f;
@@ -114,6 +130,7 @@ constexpr float FITNESS_WEIGHT_FOOD = 10.0f;
 constexpr float FITNESS_WEIGHT_LIFE = 1.0f;
 constexpr float FITNESS_WEIGHT_EXPLORE = 3.0f;
 constexpr float FITNESS_WEIGHT_PLAYERS = 5.0f;
+constexpr float FITNESS_WEIGHT_NOVELTY = 0.0f; // times the behavioural novelty (Novelty.h); 0 = novelty search off
 constexpr float FITNESS_MIN_FOOD = 5.0f;
 constexpr float FITNESS_MIN_LIFE = 2000.0f;
 constexpr float FITNESS_EARLY_DEATH_TIME = 1000.0f;
@@ -121,4 +138,77 @@ constexpr float FITNESS_EARLY_DEATH_PENALTY = 50.0f;
 constexpr float FITNESS_MIN_FOR_REPRO = 5.0f;
 constexpr float FITNESS_MIN_LIFETIME_FOR_REPRO = 2000.0f;
 constexpr float FITNESS_DIVERSITY_PRUNE_MIN_DIST = 0.2f;
+// A newcomer closer than this (genetic_distance) to a gene pool entry replaces that entry if it is
+// fitter and is dropped otherwise, instead of replacing the least fit entry; 0 = off
+constexpr float GENE_POOL_MIN_NOVELTY = 0.0f;
 constexpr float MIN_FITNESS_FOR_GENE_POOL = 100.0f;
+
+// Novelty search (FITNESS_WEIGHT_NOVELTY > 0, --novelty W)
+constexpr int NOVELTY_INTERVAL = 500; // ticks between batched novelty scorings of the alive bots
+constexpr int NOVELTY_K = 15; // neighbours a descriptor's novelty is averaged over
+constexpr int NOVELTY_FOOTPRINT_GRID = 4; // the visited-cell footprint is summed over GRID x GRID regions
+constexpr int NOVELTY_ARCHIVE_SIZE = 200000; // descriptors kept; past that a random sample of all offered
+constexpr float NOVELTY_ARCHIVE_CHANCE = 0.2f; // share of the dying bots whose descriptor is archived
+
+
+// Island Model (multi-process runs, see Island.h)
+constexpr int ISLAND_MIGRATION_INTERVAL = 5000; // ticks between migrations
+constexpr int ISLAND_MIGRANTS = 2; // top gene pool entries sent per migration
+constexpr int ISLAND_RING_SLOTS = 64; // capacity of each shared-memory migration ring
+constexpr int ISLAND_RING_SLOT_BYTES = 8192; // max encoded genome size per slot
+
+// Parameter Sweep (see Sweep.h)
+constexpr float SWEEP_FITNESS_THRESHOLD = 5000.0f; // best gene pool fitness that counts as "reached"
+
+// Profiler (see Profiler.h, compiled in with -DENABLE_PROFILER=ON)
+constexpr int PROFILER_WINDOW = 256; // ticks kept for rolling percentiles
+
+// Metrics export (see Metrics.h)
+constexpr int METRICS_INTERVAL = 1000; // ticks between streamed records
+constexpr int METRICS_QUEUE_CAPACITY = 1024; // records buffered for the writer before the oldest are dropped
+
+// World & camera (the world size can differ from the window, see --world)
+constexpr int GRID_PENDING_LIMIT = 512; // spawns since the last grid rebuild before spawning re-indexes
+constexpr float CAMERA_MAX_ZOOM = 8.0f;
+constexpr float CAMERA_ZOOM_STEP = 1.25f; // per mouse wheel notch
+
+// UI
+constexpr int TEXT_CACHE_CAPACITY = 256; // rendered sidebar strings kept as textures (LRU)
+
+// Simulation thread (see SimThread.h)
+constexpr int SIM_BASE_TPS = 60; // ticks per second at 1x speed
+constexpr int SCHEDULER_MAX_BACKLOG_MS = 250; // further behind than this, paced runs drop the backlog
+constexpr int SCHEDULER_RATE_WINDOW_MS = 500; // window of the achieved ticks/s measurement
+constexpr int SIM_SPEED_MAX = -1; // as many ticks as possible
+constexpr int SIM_SPEED_LOGIC_MAX = -2; // as many ticks as possible, snapshots only a few times a second
+constexpr int SNAPSHOT_INTERVAL_MS = 16; // render snapshots published at about display rate
+constexpr int SNAPSHOT_INTERVAL_LOGIC_MAX_MS = 250;
+constexpr int UI_FRAME_MS = 16; // the UI thread sleeps out the rest of each frame
+constexpr int GENE_POOL_SAVE_INTERVAL_MS = 5000;
+
+// Thread pool (see ThreadPool.h)
+constexpr int POOL_THREADS = 0; // including the calling thread; 0 = one per hardware thread (--threads)
+constexpr double POOL_MIN_TASK_WORK = 50000.0; // estimated float ops a task must hold to be worth handing to another thread
+
+// Replays (see Replay.h)
+constexpr int REPLAY_RECORD_INTERVAL = 1; // ticks between recorded frames
+constexpr int REPLAY_KEYFRAME_INTERVAL = 600; // frames between full-state keyframes (seek cost)
+constexpr double REPLAY_MAX_SECONDS = 10.0; // MAX speed plays a whole recording in this time
+constexpr double REPLAY_SCRUB_FRACTION = 0.05; // of the recording per LEFT/RIGHT press
+
+// Genome evaluation (see Evaluator.h)
+constexpr int EVAL_SCENARIOS = 8; // seeded micro-scenarios each genome is scored in
+constexpr int EVAL_TICKS = 5000; // longest a scenario runs; it ends early when the genome dies
+constexpr int EVAL_WORLD_SIZE = 1024; // square world of each scenario
+constexpr int EVAL_FOODS = 60;
+constexpr int EVAL_HUNTERS = 1;
+constexpr int EVAL_OPPONENTS = 6; // random-genome bots sharing the scenario
+
+// Fast math (see FastMath.h)
+constexpr bool FAST_MATH = true; // polynomial atan2/tanh/sin/cos in the tick; --exact-math uses <cmath>
+
+// Sparse inference (see SparseNet.h)
+constexpr bool SPARSE_INFERENCE = false; // long-lived and hall-of-fame bots run a pruned, compacted network (drops weights below the threshold, so outputs may differ slightly)
+constexpr float SPARSE_WEIGHT_THRESHOLD = 1e-3f; // smaller weights are dropped (and zeroed by pruning)
+constexpr int SPARSE_MIN_LIFETIME = 2000; // ticks before a bot's network is compiled
+constexpr float SPARSE_PRUNE_RATE = 0.0f; // chance per weight and offspring to be zeroed at random (0 = off); fitness does not reward fewer weights
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "SimThread.h"
+#include "Game.h"
+#include "Player.h"
+#include <chrono>
+#include <utility>
+
+SimThread::SimThread(Game& game_, RestartFn restart_) : game(game_), restart(std::move(restart_)) {}
+
+SimThread::~SimThread() {
+    stop();
+}
+
+void SimThread::start(bool start_paused, int start_speed) {
+    if (worker.joinable()) return;
+    paused = start_paused;
+    speed = start_speed;
+    stopping = false;
+    dirty = true;
+    worker = std::thread(&SimThread::loop, this);
+}
+
+void SimThread::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(command_mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void SimThread::post(const SimCommand& command) {
+    {
+        std::lock_guard<std::mutex> lock(command_mutex);
+        commands.push_back(command);
+        has_commands.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+}
+
+bool SimThread::acquire() {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    if (!has_ready) return false;
+    std::swap(front, ready);
+    has_ready = false;
+    return true;
+}
+
+void SimThread::apply(const SimCommand& command) {
+    switch (command.type) {
+        case SimCommand::Type::Pause:
+            paused = true;
+            break;
+        case SimCommand::Type::Resume:
+            paused = false;
+            resync = true;
+            break;
+        case SimCommand::Type::SetSpeed:
+            speed = command.speed;
+            resync = true;
+            break;
+        case SimCommand::Type::Restart:
+            restart(command.settings);
+            ticks = 0;
+            break;
+    }
+    dirty = true;
+}
+
+void SimThread::publish() {
+    capture_snapshot(game, back);
+    back.ticks = ticks;
+    back.paused = paused;
+    back.target_tps = scheduler.target_rate();
+    back.ticks_per_second = paused ? 0.0 : scheduler.achieved_rate();
+    back.last_tick_time = scheduler.last_tick();
+    back.tick_seconds = (paused || scheduler.unlimited()) ? 0.0 : 1.0 / scheduler.target_rate();
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    std::swap(back, ready);
+    has_ready = true;
+}
+
+double SimThread::rate_for(int speed) {
+    return speed > 0 ? double(speed) * SIM_BASE_TPS : 0.0;
+}
+
+void SimThread::loop() {
+    using clock = TickScheduler::clock;
+    using std::chrono::milliseconds;
+    auto last_publish = clock::time_point{};
+    auto last_save = clock::now();
+    scheduler.set_rate(rate_for(speed), clock::now());
+    while (true) {
+        // Sleep while paused or until the next tick is due; a command wakes us early
+        if (paused || !scheduler.due(clock::now()) || has_commands.load(std::memory_order_acquire)) {
+            std::unique_lock<std::mutex> lock(command_mutex);
+            auto until = paused ? clock::now() + milliseconds(SNAPSHOT_INTERVAL_MS) : scheduler.next_due();
+            wake.wait_until(lock, until, [&] { return stopping || !commands.empty(); });
+            if (stopping) break;
+            std::deque<SimCommand> pending;
+            pending.swap(commands);
+            has_commands.store(false, std::memory_order_relaxed);
+            lock.unlock();
+            for (const auto& command : pending) apply(command);
+        }
+        auto now = clock::now();
+        if (resync) {
+            scheduler.set_rate(rate_for(speed), now);
+            resync = false;
+        }
+        if (!paused && scheduler.due(now)) {
+            game.update();
+            ++ticks;
+            dirty = true;
+            now = clock::now();
+            scheduler.on_tick(now);
+        }
+        auto interval = milliseconds(speed == SIM_SPEED_LOGIC_MAX ? SNAPSHOT_INTERVAL_LOGIC_MAX_MS : SNAPSHOT_INTERVAL_MS);
+        if (dirty && now - last_publish >= interval) {
+            publish();
+            last_publish = now;
+            dirty = false;
+        }
+        if (now - last_save >= milliseconds(GENE_POOL_SAVE_INTERVAL_MS)) {
+            Player::save_gene_pool("gene_pool.txt");
+            last_save = now;
+        }
+    }
+}
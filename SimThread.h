@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "Settings.h"
+#include "Snapshot.h"
+#include "TickScheduler.h"
+class Game;
+
+// What a restart rebuilds the world with (the values of the settings panel)
+struct SimSettings {
+    int bot_count = MIN_BOT;
+    int food_count = NUMBER_OF_FOODS;
+    bool hunters_enabled = true;
+    int hunter_count = HUNTERS;
+    bool player_enabled = PLAYER_ENABLED;
+};
+
+struct SimCommand {
+    enum class Type { Pause, Resume, SetSpeed, Restart };
+    Type type;
+    int speed = 1;           // SetSpeed: multiple of SIM_BASE_TPS, SIM_SPEED_MAX or SIM_SPEED_LOGIC_MAX
+    SimSettings settings{};  // Restart
+};
+
+// Runs the simulation on its own thread so the window renders at display rate whatever the
+// speed. The UI only posts commands and reads the snapshots the worker publishes; while the
+// thread runs nothing else may touch the Game (except Game::pointer_x/y) or the gene pool.
+//
+// Snapshots are triple buffered: the worker fills its own buffer and swaps it into a hand-off
+// slot, acquire() swaps that slot with the UI's buffer. Neither side waits for the other
+// beyond the swap, and a published snapshot is never modified while the UI reads it.
+class SimThread {
+public:
+    using RestartFn = std::function<void(const SimSettings&)>;
+    // restart runs on the worker thread
+    SimThread(Game& game, RestartFn restart);
+    ~SimThread();
+    void start(bool paused, int speed);
+    // Finishes the current tick and joins the worker
+    void stop();
+    void post(const SimCommand& command);
+    // Takes the newest published snapshot; false if snapshot() is already the latest
+    bool acquire();
+    // The snapshot taken by the last acquire(), valid until the next one
+    const RenderSnapshot& snapshot() const { return front; }
+
+private:
+    void loop();
+    void apply(const SimCommand& command);
+    void publish();
+    // Target ticks/s of a speed step (0 = unlimited)
+    static double rate_for(int speed);
+
+    Game& game;
+    RestartFn restart;
+    std::thread worker;
+
+    std::mutex command_mutex; // guards commands and stopping
+    std::condition_variable wake;
+    std::deque<SimCommand> commands;
+    std::atomic<bool> has_commands{false};
+    bool stopping = false;
+
+    std::mutex snapshot_mutex; // guards ready and has_ready
+    RenderSnapshot front, back, ready;
+    bool has_ready = false;
+
+    // Worker-only state
+    bool paused = true;
+    int speed = 1;
+    long long ticks = 0;
+    TickScheduler scheduler;
+    bool dirty = true;   // state changed since the last publish
+    bool resync = false; // the scheduler restarts from now (after a pause or speed change)
+};
@@ -0,0 +1,90 @@
+#include "Snapshot.h"
+#include "Game.h"
+#include "Player.h"
+#include "Hunter.h"
+#include "Food.h"
+#include "Camera.h"
+#include "RenderBatch.h"
+#include "Settings.h"
+#include <algorithm>
+#include <cmath>
+
+extern thread_local int game_time_units;
+
+void capture_snapshot(const Game& game, RenderSnapshot& snapshot) {
+    using Kind = RenderSnapshot::Kind;
+    snapshot.entities.clear();
+    snapshot.top_bots.clear();
+    snapshot.world_width = game.width;
+    snapshot.world_height = game.height;
+    snapshot.alive_players = game.population.alive();
+    snapshot.has_human = false;
+    // Bots first, hunters on top of them, then food
+    for (const auto* p : game.players) {
+        if (!p) continue;
+        if (p->is_hunter) continue;
+        Kind kind = p->is_human ? Kind::Human : Kind::Bot;
+        SDL_Color opaque = {p->color.r, p->color.g, p->color.b, 255};
+        float px = std::isnan(p->prev_x) ? p->x : p->prev_x;
+        float py = std::isnan(p->prev_y) ? p->y : p->prev_y;
+        snapshot.entities.push_back({p->x, p->y, px, py, p->width, p->height, opaque, p->angle, p->speed, kind});
+        if (p->alive && p->is_human) {
+            snapshot.has_human = true;
+            snapshot.human = {p->color, p->width, p->foodCount, p->lifeTime};
+        }
+    }
+    for (const auto* h : game.hunters) {
+        if (!h) continue;
+        float px = std::isnan(h->prev_x) ? h->x : h->prev_x;
+        float py = std::isnan(h->prev_y) ? h->y : h->prev_y;
+        snapshot.entities.push_back({h->x, h->y, px, py, h->width, h->height, {255, 0, 0, 255}, 0.0f, 0.0f, Kind::Hunter});
+    }
+    for (const auto* f : game.foods) {
+        if (f) snapshot.entities.push_back({f->x, f->y, f->x, f->y, f->width, f->height, {0, 255, 0, 255}, 0.0f, 0.0f, Kind::Food});
+    }
+    for (const auto* p : game.top_bots.top(game.players)) {
+        snapshot.top_bots.push_back({p->color, p->width, p->foodCount, p->lifeTime});
+    }
+    snapshot.total_hunters = (int)game.hunters.size();
+    snapshot.total_food = (int)game.foods.size();
+    snapshot.game_time_units = game_time_units;
+    snapshot.best_fitness = Player::display_best_fitness;
+    snapshot.avg_fitness = Player::display_avg_fitness;
+    snapshot.last_fitness = Player::display_last_fitness;
+    snapshot.avg_diversity = Player::display_avg_diversity;
+    snapshot.mutation_rate = Player::display_mutation_rate;
+    for (int i = 0; i < TickProfiler::PHASES; ++i) {
+        snapshot.phase_p50_us[i] = TickProfiler::percentile_us(static_cast<ProfilePhase>(i), 0.5f);
+        snapshot.phase_p99_us[i] = TickProfiler::percentile_us(static_cast<ProfilePhase>(i), 0.99f);
+    }
+}
+
+float RenderSnapshot::interpolation_alpha(std::chrono::steady_clock::time_point now) const {
+    if (paused || tick_seconds <= 0.0) return 1.0f;
+    double since = std::chrono::duration<double>(now - last_tick_time).count();
+    return static_cast<float>(std::clamp(since / tick_seconds, 0.0, 1.0));
+}
+
+void draw_snapshot(const RenderSnapshot& snapshot, const Camera& camera, RenderBatch& batch, float alpha) {
+    const SDL_Color white = {255, 255, 255, 255};
+    for (const auto& e : snapshot.entities) {
+        float x = e.prev_x + (e.x - e.prev_x) * alpha;
+        float y = e.prev_y + (e.y - e.prev_y) * alpha;
+        if (!camera.visible(x, y, e.width, e.height)) continue;
+        batch.fill_rect(camera.to_screen(x, y, e.width, e.height), e.color);
+        if (e.kind != RenderSnapshot::Kind::Bot && e.kind != RenderSnapshot::Kind::Human) continue;
+        // Direction arrow (half as long, with arrowhead), in screen space
+        int scx, scy;
+        camera.to_screen_point(x, y, scx, scy);
+        float cx = float(scx);
+        float cy = float(scy);
+        float len = (10.0f + 10.0f * (e.speed / MAX_SPEED)) * 0.5f * camera.zoom;
+        float ex = cx + std::cos(e.angle) * len;
+        float ey = cy + std::sin(e.angle) * len;
+        batch.line(cx, cy, ex, ey, white);
+        float head_len = len * 0.5f;
+        float head_angle = 0.5f; // radians, ~28 degrees
+        batch.line(ex, ey, ex - std::cos(e.angle - head_angle) * head_len, ey - std::sin(e.angle - head_angle) * head_len, white);
+        batch.line(ex, ey, ex - std::cos(e.angle + head_angle) * head_len, ey - std::sin(e.angle + head_angle) * head_len, white);
+    }
+}
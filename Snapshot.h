@@ -0,0 +1,55 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <chrono>
+#include <vector>
+#include "Profiler.h"
+class Game;
+struct Camera;
+class RenderBatch;
+
+// Everything the UI draws for one frame, copied out of the Game by the simulation thread.
+// Once published a snapshot is never written again, so the UI can read it without locks.
+struct RenderSnapshot {
+    enum class Kind : Uint8 { Bot, Human, Hunter, Food };
+    struct Entity {
+        float x, y;
+        float prev_x, prev_y; // position before the last tick, for interpolation
+        int width, height;
+        SDL_Color color;
+        float angle, speed; // bots and humans: drawn as a direction arrow
+        Kind kind;
+    };
+    struct BotStats {
+        SDL_Color color;
+        int width, food_count, life_time;
+    };
+    std::vector<Entity> entities; // draw order: bots, hunters, food
+    int world_width = 0, world_height = 0;
+    // Sidebar stats
+    long long ticks = 0;         // ticks since the last restart
+    int game_time_units = 0;
+    int alive_players = 0, total_hunters = 0, total_food = 0;
+    std::vector<BotStats> top_bots; // by food count, at most TopBots::K
+    bool has_human = false;
+    BotStats human{};
+    float best_fitness = 0.0f, avg_fitness = 0.0f, last_fitness = 0.0f;
+    float avg_diversity = 0.0f, mutation_rate = 0.0f;
+    bool paused = false;
+    double ticks_per_second = 0.0; // achieved
+    double target_tps = 0.0;       // 0 = unlimited
+    // When the last tick ran and the fixed timestep (0 when not paced), for interpolation
+    std::chrono::steady_clock::time_point last_tick_time{};
+    double tick_seconds = 0.0;
+    std::array<float, TickProfiler::PHASES> phase_p50_us{}, phase_p99_us{};
+
+    // Where between the previous and the last tick a frame drawn at now falls (0..1). Drawing
+    // one tick behind keeps motion smooth when the tick rate and the frame rate differ.
+    float interpolation_alpha(std::chrono::steady_clock::time_point now) const;
+};
+
+// Copies the game state into snapshot (reusing its storage)
+void capture_snapshot(const Game& game, RenderSnapshot& snapshot);
+// Emits the entities the camera can see into the batch, alpha of the way from their previous
+// to their last position
+void draw_snapshot(const RenderSnapshot& snapshot, const Camera& camera, RenderBatch& batch, float alpha = 1.0f);
@@ -0,0 +1,124 @@
+#include "SparseNet.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace {
+    constexpr int LAYERS = int(NEURAL_NET_SHAPE.size());
+
+    float leaky_relu(float x) { return x > 0.0f ? x : 0.01f * x; }
+
+    int layer_inputs(int l) { return std::get<0>(NEURAL_NET_SHAPE[l]); }
+    int layer_outputs(int l) { return std::get<1>(NEURAL_NET_SHAPE[l]); }
+}
+
+SparseNet::SparseNet(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, float threshold) {
+    if (int(genes.size()) != LAYERS || int(biases.size()) != LAYERS) return;
+    for (int l = 0; l < LAYERS; ++l) {
+        if (int(genes[l].size()) != layer_inputs(l) * layer_outputs(l) || int(biases[l].size()) != layer_outputs(l)) return;
+    }
+    // keep[l][i * out + j]: the weight from input i to neuron j of layer l survives
+    std::vector<std::vector<bool>> keep(LAYERS);
+    std::vector<std::vector<float>> bias(LAYERS);
+    for (int l = 0; l < LAYERS; ++l) {
+        keep[l].resize(genes[l].size());
+        for (size_t k = 0; k < genes[l].size(); ++k) keep[l][k] = std::fabs(genes[l][k]) >= threshold;
+        bias[l] = biases[l];
+    }
+
+    // Forward: neurons left without inputs are constants, folded into the next layer's biases.
+    // live[l] marks the inputs of layer l that still vary (all network inputs do).
+    std::vector<std::vector<bool>> live(LAYERS + 1);
+    live[0].assign(layer_inputs(0), true);
+    for (int l = 0; l < LAYERS; ++l) {
+        const int in = layer_inputs(l), out = layer_outputs(l);
+        live[l + 1].assign(out, true);
+        if (l == LAYERS - 1) break; // outputs are never folded
+        for (int j = 0; j < out; ++j) {
+            bool fed = false;
+            for (int i = 0; i < in && !fed; ++i) fed = live[l][i] && keep[l][i * out + j];
+            if (fed) continue;
+            live[l + 1][j] = false;
+            const float constant = leaky_relu(bias[l][j]);
+            const int next_out = layer_outputs(l + 1);
+            for (int k = 0; k < next_out; ++k) {
+                if (keep[l + 1][j * next_out + k]) bias[l + 1][k] += constant * genes[l + 1][j * next_out + k];
+            }
+        }
+    }
+
+    // Backward: hidden neurons that feed nothing that is computed are dropped
+    std::vector<std::vector<bool>> used(LAYERS + 1);
+    used[LAYERS].assign(layer_outputs(LAYERS - 1), true);
+    for (int l = LAYERS - 1; l >= 0; --l) {
+        const int in = layer_inputs(l), out = layer_outputs(l);
+        used[l].assign(in, false);
+        for (int i = 0; i < in; ++i) {
+            if (!live[l][i]) continue;
+            for (int j = 0; j < out && !used[l][i]; ++j) used[l][i] = used[l + 1][j] && keep[l][i * out + j];
+        }
+    }
+
+    // Rows: the computed neurons of each layer, columns renumbered to the previous layer's rows
+    std::vector<int> row_of(layer_inputs(0));
+    for (int i = 0; i < layer_inputs(0); ++i) row_of[i] = i;
+    for (int l = 0; l < LAYERS; ++l) {
+        const int in = layer_inputs(l), out = layer_outputs(l);
+        Layer layer;
+        layer.row_start.push_back(uint16_t(values.size()));
+        std::vector<int> next_row_of(out, -1);
+        for (int j = 0; j < out; ++j) {
+            const bool computed = l == LAYERS - 1 || (live[l + 1][j] && used[l + 1][j]);
+            if (!computed) continue;
+            next_row_of[j] = int(layer.bias.size());
+            for (int i = 0; i < in; ++i) {
+                if (l > 0 && !used[l][i]) continue;
+                if (!live[l][i] || !keep[l][i * out + j]) continue;
+                columns.push_back(uint8_t(row_of[i]));
+                values.push_back(genes[l][i * out + j]);
+            }
+            layer.row_start.push_back(uint16_t(values.size()));
+            layer.bias.push_back(bias[l][j]);
+        }
+        layers.push_back(std::move(layer));
+        row_of = std::move(next_row_of);
+    }
+}
+
+int SparseNet::hidden_neurons() const {
+    int count = 0;
+    for (size_t l = 0; l + 1 < layers.size(); ++l) count += int(layers[l].bias.size());
+    return count;
+}
+
+std::array<float, NN_OUTPUTS> SparseNet::forward(const std::array<float, NN_INPUTS>& input) const {
+    std::array<float, NN_INPUTS + NN_H1 + NN_H2 + NN_H3> buffer;
+    std::copy(input.begin(), input.end(), buffer.begin());
+    const float* in = buffer.data();
+    float* out = buffer.data() + NN_INPUTS;
+    std::array<float, NN_OUTPUTS> output{};
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const Layer& layer = layers[l];
+        const int rows = int(layer.bias.size());
+        const bool last = l + 1 == layers.size();
+        for (int r = 0; r < rows; ++r) {
+            float acc = 0.0f;
+            for (int k = layer.row_start[r]; k < layer.row_start[r + 1]; ++k) acc += in[columns[k]] * values[k];
+            acc += layer.bias[r];
+            if (last) output[r] = acc;
+            else out[r] = leaky_relu(acc);
+        }
+        in = out;
+        out += rows;
+    }
+    return output;
+}
+
+void prune_genes(std::vector<std::vector<float>>& genes, float rate) {
+    for (auto& layer : genes) {
+        for (float& w : layer) {
+            if (std::fabs(w) < SPARSE_WEIGHT_THRESHOLD || sim_rand_float() < rate) w = 0.0f;
+        }
+    }
+}
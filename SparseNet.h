@@ -0,0 +1,38 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Settings.h"
+
+// A genome compiled for inference with its near-zero weights dropped. Weights below the
+// threshold are treated as zero, then dead neurons are collapsed:
+//   - a hidden neuron without incoming weights is a constant; it is folded into the biases
+//     of the next layer
+//   - a hidden neuron whose outgoing weights are all gone is never computed
+// Each layer is stored in CSR form: one row per neuron that is still computed, holding the
+// (input, weight) pairs that survived. The result depends only on genes and biases, which
+// never change during a Player's life, so a Player compiles it once (see
+// Player::compile_sparse_network).
+class SparseNet {
+public:
+    // Empty when the genes do not have the NEURAL_NET_SHAPE layout
+    SparseNet(const std::vector<std::vector<float>>& genes, const std::vector<std::vector<float>>& biases, float threshold);
+    bool empty() const { return layers.empty(); }
+    // Output layer before its activation, like the dense pass in Player::forward
+    std::array<float, NN_OUTPUTS> forward(const std::array<float, NN_INPUTS>& input) const;
+    size_t weights() const { return values.size(); } // kept weights, out of NN_WEIGHT_COUNT
+    int hidden_neurons() const;                      // still computed, out of NN_H1 + NN_H2 + NN_H3
+
+private:
+    struct Layer {
+        std::vector<uint16_t> row_start; // rows + 1 offsets into columns/values
+        std::vector<float> bias;         // per row, with the folded constants
+    };
+    std::vector<Layer> layers;
+    std::vector<uint8_t> columns; // index of the input in the previous layer's rows (raw input index in layer 0)
+    std::vector<float> values;
+};
+
+// Zeroes weights smaller than SPARSE_WEIGHT_THRESHOLD and each other weight with the given
+// chance. This is random zeroing only: fitness has no term for the weight count
+void prune_genes(std::vector<std::vector<float>>& genes, float rate);
@@ -0,0 +1,156 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Uniform grid over a runtime-sized world, rebuilt from scratch with a counting sort.
+// All items live in one flat array ordered by cell; the items of cell c are
+// items[cell_start[c] .. cell_start[c + 1]), so a neighbourhood query walks a few
+// contiguous spans instead of one heap-allocated vector per cell.
+// T needs float x, y (centre) and int width, height.
+template <typename T>
+class SpatialGrid {
+public:
+    void resize(int world_width, int world_height, int cell_size) {
+        cell = std::max(1, cell_size);
+        cols = std::max(1, (world_width + cell - 1) / cell);
+        rows = std::max(1, (world_height + cell - 1) / cell);
+        clear();
+    }
+
+    void clear() {
+        cell_start.assign(size_t(cols) * rows + 1, 0);
+        items.clear();
+        max_half_size = 0.0f;
+    }
+
+    template <typename Keep>
+    void rebuild(const std::vector<T*>& source, Keep keep) {
+        const int cells = cols * rows;
+        cell_start.assign(size_t(cells) + 1, 0);
+        item_cell.resize(source.size());
+        max_half_size = 0.0f;
+        // Count items per cell
+        for (size_t i = 0; i < source.size(); ++i) {
+            const T* item = source[i];
+            if (!item || !keep(item)) { item_cell[i] = -1; continue; }
+            int c = cell_index(cell_x(item->x), cell_y(item->y));
+            item_cell[i] = c;
+            ++cell_start[c + 1];
+            max_half_size = std::max(max_half_size, std::max(item->width, item->height) / 2.0f);
+        }
+        // Prefix sums give each cell's first slot, then scatter
+        for (int c = 0; c < cells; ++c) cell_start[c + 1] += cell_start[c];
+        items.resize(cell_start[cells]);
+        cursor.assign(cell_start.begin(), cell_start.end() - 1);
+        for (size_t i = 0; i < source.size(); ++i) {
+            if (item_cell[i] >= 0) items[cursor[item_cell[i]]++] = source[i];
+        }
+    }
+
+    void rebuild(const std::vector<T*>& source) {
+        rebuild(source, [](const T*) { return true; });
+    }
+
+    // Blanks the slot of an item that is deleted before the next rebuild (the item must not
+    // have moved since). Queries skip blanked slots. Returns false if it was not indexed.
+    bool remove(const T* item) {
+        int c = cell_index(cell_x(item->x), cell_y(item->y));
+        for (int i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+            if (items[i] == item) { items[i] = nullptr; return true; }
+        }
+        return false;
+    }
+
+    int cell_x(float x) const { return std::clamp(static_cast<int>(std::floor(x / cell)), 0, cols - 1); }
+    int cell_y(float y) const { return std::clamp(static_cast<int>(std::floor(y / cell)), 0, rows - 1); }
+    int cell_size() const { return cell; }
+    int columns() const { return cols; }
+    int row_count() const { return rows; }
+    size_t size() const { return items.size(); }
+    // The indexed items in cell order (nullptr where one was removed since the rebuild)
+    const std::vector<T*>& items_by_cell() const { return items; }
+    // Largest max(width, height) / 2 of the indexed items, to widen overlap queries
+    float max_extent() const { return max_half_size; }
+
+    // Calls f(T*) for every item in the cells from (x0, y0) to (x1, y1) inclusive
+    template <typename F>
+    void for_each_in_cells(int x0, int y0, int x1, int y1, F&& f) const {
+        x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+        x1 = std::min(x1, cols - 1); y1 = std::min(y1, rows - 1);
+        if (x0 > x1 || y0 > y1) return; // entirely outside the grid
+        for (int cy = y0; cy <= y1; ++cy) {
+            int first = cell_start[cell_index(x0, cy)];
+            int last = cell_start[cell_index(x1, cy) + 1]; // a row of cells is one contiguous span
+            for (int i = first; i < last; ++i) {
+                if (items[i]) f(items[i]);
+            }
+        }
+    }
+
+    // Calls f(T*) for every item whose cell overlaps the square of half-size radius around (x, y)
+    template <typename F>
+    void for_each_near(float x, float y, float radius, F&& f) const {
+        for_each_in_cells(cell_x(x - radius), cell_y(y - radius), cell_x(x + radius), cell_y(y + radius), f);
+    }
+
+    // Exact nearest item under metric(item), which returns +inf to reject an item. The metric
+    // must never be smaller than the centre distance minus slack; the rings of cells around
+    // (x, y) are searched outwards until no unvisited cell can hold anything closer.
+    // runner_up, if given, receives a lower bound on the metric of every other item: the
+    // second best seen, or less where the search stopped before reaching it.
+    template <typename Metric>
+    T* nearest(float x, float y, float slack, Metric&& metric, float& best, float* runner_up = nullptr) const {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        T* found = nullptr;
+        float second = inf;
+        const int cx = cell_x(x), cy = cell_y(y);
+        const int max_ring = std::max(std::max(cx, cols - 1 - cx), std::max(cy, rows - 1 - cy));
+        auto visit = [&](T* item) {
+            float d = metric(item);
+            if (d < best) {
+                if (found) second = best;
+                best = d;
+                found = item;
+            } else if (d < second) {
+                second = d;
+            }
+        };
+        for (int r = 0; r <= max_ring; ++r) {
+            if (r == 0) {
+                for_each_in_cells(cx, cy, cx, cy, visit);
+            } else {
+                for_each_in_cells(cx - r, cy - r, cx + r, cy - r, visit); // top row
+                for_each_in_cells(cx - r, cy + r, cx + r, cy + r, visit); // bottom row
+                for_each_in_cells(cx - r, cy - r + 1, cx - r, cy + r - 1, visit); // left column
+                for_each_in_cells(cx + r, cy - r + 1, cx + r, cy + r - 1, visit); // right column
+            }
+            // Distance from (x, y) to the nearest cell outside the searched square (grid edges excluded)
+            float bound = inf;
+            if (cx - r > 0) bound = std::min(bound, x - float(cx - r) * cell);
+            if (cx + r < cols - 1) bound = std::min(bound, float(cx + r + 1) * cell - x);
+            if (cy - r > 0) bound = std::min(bound, y - float(cy - r) * cell);
+            if (cy + r < rows - 1) bound = std::min(bound, float(cy + r + 1) * cell - y);
+            if (bound == inf) break;
+            if (bound - slack >= best) {
+                second = std::min(second, bound - slack);
+                break;
+            }
+        }
+        if (runner_up) *runner_up = second;
+        return found;
+    }
+
+private:
+    int cell_index(int x, int y) const { return y * cols + x; }
+
+    int cell = 1;
+    int cols = 1;
+    int rows = 1;
+    float max_half_size = 0.0f;
+    std::vector<int> cell_start{0, 0}; // cols * rows + 1 prefix sums
+    std::vector<T*> items;             // sorted by cell; nullptr = removed since the rebuild
+    std::vector<int> item_cell;        // rebuild scratch
+    std::vector<int> cursor;           // rebuild scratch
+};
@@ -0,0 +1,234 @@
+#include "Sweep.h"
+#include "Game.h"
+#include "Player.h"
+#include "Tunables.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#define SWEEP_SUPPORTED 1
+#endif
+
+namespace {
+    struct SweepRun {
+        int variant;
+        int repeat;
+        unsigned int seed;
+    };
+
+    // Fixed-size record a worker process writes back through its pipe
+    struct SweepRunResult {
+        long long ticks = 0;
+        float best_fitness = 0.0f;
+        long long ticks_to_threshold = -1; // -1 = never reached
+        double seconds_to_threshold = -1.0;
+        double ticks_per_second = 0.0;
+    };
+
+    std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r");
+        size_t e = s.find_last_not_of(" \t\r");
+        return b == std::string::npos ? "" : s.substr(b, e - b + 1);
+    }
+
+    // Cartesian product of the value lists, or config.samples random picks
+    std::vector<std::vector<double>> build_variants(const SweepConfig& config, unsigned int seed) {
+        std::vector<std::vector<double>> variants;
+        bool any_range = std::any_of(config.params.begin(), config.params.end(), [](const SweepParameter& p) { return p.is_range; });
+        if (config.samples > 0 || any_range) {
+            std::mt19937 rng(seed);
+            int samples = config.samples > 0 ? config.samples : 16;
+            for (int s = 0; s < samples; ++s) {
+                std::vector<double> values;
+                for (const auto& p : config.params) {
+                    if (p.is_range) values.push_back(std::uniform_real_distribution<double>(p.min, p.max)(rng));
+                    else values.push_back(p.values[std::uniform_int_distribution<size_t>(0, p.values.size() - 1)(rng)]);
+                }
+                variants.push_back(values);
+            }
+            return variants;
+        }
+        variants.push_back({});
+        for (const auto& p : config.params) {
+            std::vector<std::vector<double>> expanded;
+            for (const auto& partial : variants) {
+                for (double v : p.values) {
+                    expanded.push_back(partial);
+                    expanded.back().push_back(v);
+                }
+            }
+            variants = expanded;
+        }
+        return variants;
+    }
+
+    // Runs one variant in the current (worker) process
+    SweepRunResult execute_run(const SweepConfig& config, const std::vector<double>& values, unsigned int seed) {
+        g_tunables = Tunables();
+        for (size_t i = 0; i < config.params.size(); ++i) g_tunables.set(config.params[i].name, values[i]);
+        // Every run starts from scratch and must not touch the shared gene pool files
+        Player::gene_pool.clear();
+        Player::gene_pool_changed();
+        Player::hall_of_fame.clear();
+        Player::hall_of_fame_file.clear();
+        Player::adaptive_mutation_rate = g_tunables.mutation_rate;
+        HeadlessConfig sim = config.sim;
+        sim.seed = seed;
+        sim.metrics.path.clear(); // concurrent runs would interleave in one stream; the sweep CSV is the summary
+        sim.record.path.clear();
+        for (const auto& p : config.params) {
+            if (p.name == "NUMBER_OF_FOODS") sim.foods = g_tunables.number_of_foods;
+            else if (p.name == "HUNTERS") sim.hunters = g_tunables.hunters;
+            else if (p.name == "MIN_BOT") sim.bots = g_tunables.min_bot;
+        }
+        SweepRunResult result;
+        Game game(nullptr);
+        populate_headless(game, sim);
+        auto start = std::chrono::steady_clock::now();
+        HeadlessResult run = run_headless(game, sim, [&](Game&, long long tick) {
+            if (result.ticks_to_threshold < 0 && !Player::gene_pool.empty() && Player::gene_pool.front().fitness >= config.fitness_threshold) {
+                result.ticks_to_threshold = tick;
+                result.seconds_to_threshold = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            return true;
+        });
+        result.ticks = run.ticks;
+        result.best_fitness = run.best_fitness;
+        result.ticks_per_second = run.ticks_per_second;
+        return result;
+    }
+}
+
+bool load_sweep_spec(const std::string& path, SweepConfig& config) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        std::cerr << "Could not open sweep spec " << path << std::endl;
+        return false;
+    }
+    std::vector<std::string> known = Tunables::names();
+    std::string line;
+    int line_no = 0;
+    while (std::getline(ifs, line)) {
+        ++line_no;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << path << ":" << line_no << ": expected NAME = values" << std::endl;
+            return false;
+        }
+        SweepParameter param;
+        param.name = trim(line.substr(0, eq));
+        std::string values = trim(line.substr(eq + 1));
+        if (std::find(known.begin(), known.end(), param.name) == known.end()) {
+            std::cerr << path << ":" << line_no << ": unknown tunable " << param.name << std::endl;
+            return false;
+        }
+        size_t dots = values.find("..");
+        try {
+            if (dots != std::string::npos) {
+                param.is_range = true;
+                param.min = std::stod(values.substr(0, dots));
+                param.max = std::stod(values.substr(dots + 2));
+            } else {
+                std::istringstream iss(values);
+                std::string item;
+                while (std::getline(iss, item, ',')) param.values.push_back(std::stod(item));
+            }
+        } catch (const std::exception&) {
+            std::cerr << path << ":" << line_no << ": could not parse values" << std::endl;
+            return false;
+        }
+        if (!param.is_range && param.values.empty()) {
+            std::cerr << path << ":" << line_no << ": no values for " << param.name << std::endl;
+            return false;
+        }
+        config.params.push_back(param);
+    }
+    return !config.params.empty();
+}
+
+#ifdef SWEEP_SUPPORTED
+int run_sweep(const SweepConfig& config) {
+    unsigned int base_seed = config.sim.seed != 0 ? config.sim.seed : static_cast<unsigned int>(time(nullptr));
+    std::vector<std::vector<double>> variants = build_variants(config, base_seed);
+    // Repeat r of every variant uses the same seed, so variants are compared on the same worlds
+    std::vector<SweepRun> runs;
+    for (int v = 0; v < (int)variants.size(); ++v)
+        for (int r = 0; r < std::max(1, config.repeats); ++r)
+            runs.push_back({v, r, base_seed + 7919u * r});
+    int jobs = config.jobs > 0 ? config.jobs : std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    std::cout << "[sweep] " << variants.size() << " variants, " << runs.size() << " runs, " << jobs << " concurrent jobs" << std::endl;
+
+    struct ActiveRun { pid_t pid; int fd; size_t run; };
+    std::vector<ActiveRun> active;
+    std::vector<SweepRunResult> results(runs.size());
+    std::vector<bool> ok(runs.size(), false);
+    size_t next = 0, finished = 0;
+    int failed = 0;
+    while (next < runs.size() || !active.empty()) {
+        while (next < runs.size() && (int)active.size() < jobs) {
+            int fds[2];
+            if (pipe(fds) != 0) break;
+            std::cout.flush();
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(fds[0]);
+                SweepRunResult result = execute_run(config, variants[runs[next].variant], runs[next].seed);
+                ssize_t written = write(fds[1], &result, sizeof(result));
+                _exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+            }
+            close(fds[1]);
+            if (pid < 0) {
+                close(fds[0]);
+                std::cerr << "[sweep] could not fork run " << next << std::endl;
+                ++failed;
+                ++next;
+                continue;
+            }
+            active.push_back({pid, fds[0], next++});
+        }
+        if (active.empty()) break;
+        int wstatus = 0;
+        pid_t done = waitpid(-1, &wstatus, 0);
+        auto it = std::find_if(active.begin(), active.end(), [done](const ActiveRun& a) { return a.pid == done; });
+        if (it == active.end()) continue;
+        bool read_ok = read(it->fd, &results[it->run], sizeof(SweepRunResult)) == (ssize_t)sizeof(SweepRunResult);
+        ok[it->run] = read_ok && WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0;
+        if (!ok[it->run]) {
+            std::cerr << "[sweep] run " << it->run << " failed" << std::endl;
+            ++failed;
+        }
+        close(it->fd);
+        active.erase(it);
+        std::cout << "[sweep] " << ++finished << "/" << runs.size() << " done" << std::endl;
+    }
+
+    std::ofstream ofs(config.output);
+    ofs << "run,variant,repeat,seed";
+    for (const auto& p : config.params) ofs << ',' << p.name;
+    ofs << ",best_fitness,ticks_to_threshold,seconds_to_threshold,ticks_per_second,status\n";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const SweepRunResult& r = results[i];
+        ofs << i << ',' << runs[i].variant << ',' << runs[i].repeat << ',' << runs[i].seed;
+        for (double v : variants[runs[i].variant]) ofs << ',' << v;
+        ofs << ',' << r.best_fitness << ',' << r.ticks_to_threshold << ',' << r.seconds_to_threshold
+            << ',' << std::round(r.ticks_per_second * 10.0) / 10.0
+            << ',' << (ok[i] ? "ok" : "failed") << '\n';
+    }
+    std::cout << "[sweep] results written to " << config.output << std::endl;
+    return failed;
+}
+#else
+int run_sweep(const SweepConfig& config) {
+    std::cerr << "The parameter sweep requires fork(), which is not available on this platform" << std::endl;
+    return 1;
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Settings.h"
+#include "Headless.h"
+
+// One swept tuning value (a Tunables name from Settings.h).
+// Either a list of values or, when is_range is set, a uniform [min, max] range.
+struct SweepParameter {
+    std::string name;
+    std::vector<double> values;
+    bool is_range = false;
+    double min = 0.0, max = 0.0;
+};
+
+struct SweepConfig {
+    std::vector<SweepParameter> params;
+    int samples = 0; // 0 = full grid over the value lists, otherwise number of random variants
+    int repeats = 1; // runs per variant (with different seeds)
+    int jobs = 0; // concurrent simulations, 0 = one per online core
+    float fitness_threshold = SWEEP_FITNESS_THRESHOLD;
+    std::string output = "sweep_results.csv";
+    HeadlessConfig sim;
+};
+
+// Reads a sweep spec file. Each non-comment line is either
+//   NAME = v1, v2, v3     (value list, used for the grid)
+//   NAME = min..max       (range, sampled uniformly; implies random sampling)
+bool load_sweep_spec(const std::string& path, SweepConfig& config);
+// Runs every variant as a separate headless process (up to config.jobs at once) and
+// writes one CSV row per run. Returns the number of runs that failed.
+int run_sweep(const SweepConfig& config);
@@ -0,0 +1,37 @@
+#include "TextCache.h"
+
+void TextCache::draw(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
+    if (text.empty()) return;
+    std::string key = text;
+    key.push_back('\0');
+    key.append({char(color.r), char(color.g), char(color.b), char(color.a)});
+    auto found = index.find(key);
+    if (found != index.end()) {
+        ++hits;
+        entries.splice(entries.begin(), entries, found->second);
+    } else {
+        ++misses;
+        SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
+        if (!surface) return;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        int w = surface->w, h = surface->h;
+        SDL_FreeSurface(surface);
+        if (!texture) return;
+        if (entries.size() >= capacity && !entries.empty()) {
+            SDL_DestroyTexture(entries.back().texture);
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+        entries.push_front({key, texture, w, h});
+        index[key] = entries.begin();
+    }
+    const Entry& entry = entries.front();
+    SDL_Rect dst = {x, y, entry.w, entry.h};
+    SDL_RenderCopy(renderer, entry.texture, NULL, &dst);
+}
+
+void TextCache::clear() {
+    for (auto& entry : entries) SDL_DestroyTexture(entry.texture);
+    entries.clear();
+    index.clear();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include "Settings.h"
+
+// LRU cache of rendered text textures keyed by text and colour. Sidebar labels mostly
+// repeat from frame to frame, so they are rasterised once and then only copied.
+class TextCache {
+public:
+    explicit TextCache(size_t capacity = TEXT_CACHE_CAPACITY) : capacity(capacity) {}
+    ~TextCache() { clear(); }
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    // Draws text with its top-left corner at (x, y), rendering it first on a miss
+    void draw(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+    // Destroys all textures; call before the renderer goes away
+    void clear();
+    size_t size() const { return entries.size(); }
+    long long hits = 0;
+    long long misses = 0;
+
+private:
+    struct Entry {
+        std::string key;
+        SDL_Texture* texture;
+        int w, h;
+    };
+    size_t capacity;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
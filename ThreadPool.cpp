@@ -0,0 +1,200 @@
+#include "ThreadPool.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define POOL_FORK_AWARE 1
+#endif
+
+int g_pool_threads = POOL_THREADS;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // The pool and queue of the calling thread (a worker, or the outside thread while it drives
+    // a loop), and how many tasks it is nested in
+    thread_local const ThreadPool* current_pool = nullptr;
+    thread_local int current_slot = -1;
+    thread_local int task_depth = 0;
+
+    // Waits that found nothing to run yield this many times, then sleep briefly between checks
+    constexpr int SPIN_YIELDS = 64;
+
+    std::mutex shared_mutex;
+    std::unique_ptr<ThreadPool> shared_owner; // joined at exit
+    std::atomic<ThreadPool*> shared_pool{nullptr};
+
+#ifdef POOL_FORK_AWARE
+    // A forked child (an island, a sweep run) inherits the pool but none of its threads, so
+    // that pool is abandoned rather than joined and the child starts its own
+    void abandon_shared_pool() {
+        (void)shared_owner.release();
+        shared_pool.store(nullptr);
+    }
+#endif
+}
+
+ThreadPool& ThreadPool::shared() {
+    if (ThreadPool* pool = shared_pool.load(std::memory_order_acquire)) return *pool;
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (!shared_owner) {
+#ifdef POOL_FORK_AWARE
+        static bool registered = (pthread_atfork(nullptr, nullptr, abandon_shared_pool), true);
+        (void)registered;
+#endif
+        int threads = g_pool_threads > 0 ? g_pool_threads : int(std::max(1u, std::thread::hardware_concurrency()));
+        shared_owner = std::make_unique<ThreadPool>(threads);
+        shared_pool.store(shared_owner.get(), std::memory_order_release);
+    }
+    return *shared_owner;
+}
+
+ThreadPool::ThreadPool(int threads) : created(Clock::now()) {
+    threads = std::max(1, threads);
+    for (int i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+    for (int slot = 1; slot < threads; ++slot) workers.emplace_back(&ThreadPool::worker_loop, this, slot);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::run(size_t n, size_t grain, void (*invoke)(void*, size_t, size_t), void* body) {
+    // An outside thread drives the pool from slot 0, one at a time; another one that arrives
+    // meanwhile runs its loop alone
+    std::unique_lock<std::mutex> outside;
+    const ThreadPool* previous_pool = current_pool;
+    const int previous_slot = current_slot;
+    if (current_pool != this) {
+        outside = std::unique_lock<std::mutex>(outside_mutex, std::try_to_lock);
+        if (!outside.owns_lock()) {
+            inline_loops.fetch_add(1, std::memory_order_relaxed);
+            invoke(body, 0, n);
+            return;
+        }
+        current_pool = this;
+        current_slot = 0;
+    }
+    const int slot = current_slot;
+    parallel_loops.fetch_add(1, std::memory_order_relaxed);
+    Loop loop;
+    loop.invoke = invoke;
+    loop.body = body;
+    loop.grain = std::max<size_t>(grain, 1);
+    loop.remaining.store(n, std::memory_order_relaxed);
+    execute(slot, {&loop, 0, n});
+    // Help with the pieces of this loop until the ones taken by other threads are done
+    for (int idle = 0; loop.remaining.load(std::memory_order_acquire) > 0;) {
+        Task task;
+        if (pop(slot, task, &loop) || steal(slot, task, &loop)) {
+            execute(slot, task);
+            idle = 0;
+        } else if (++idle < SPIN_YIELDS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    current_pool = previous_pool;
+    current_slot = previous_slot;
+    if (loop.error) std::rethrow_exception(loop.error);
+}
+
+void ThreadPool::worker_loop(int slot) {
+    current_pool = this;
+    current_slot = slot;
+    for (;;) {
+        Task task;
+        if (pop(slot, task, nullptr) || steal(slot, task, nullptr)) {
+            execute(slot, task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [&] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+void ThreadPool::execute(int slot, Task task) {
+    const auto start = Clock::now();
+    Loop* loop = task.loop;
+    // Keep the first half, offer the rest
+    while (task.end - task.begin > loop->grain) {
+        const size_t mid = task.begin + (task.end - task.begin) / 2;
+        push(slot, {loop, mid, task.end});
+        task.end = mid;
+    }
+    ++task_depth;
+    try {
+        loop->invoke(loop->body, task.begin, task.end);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(loop->error_mutex);
+        if (!loop->error) loop->error = std::current_exception();
+    }
+    --task_depth;
+    Queue& queue = *queues[slot];
+    // Time inside nested loops is already counted by the outermost task
+    if (task_depth == 0) {
+        queue.busy_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(), std::memory_order_relaxed);
+    }
+    queue.done.fetch_add(1, std::memory_order_relaxed);
+    // The loop may be gone as soon as this reaches zero
+    loop->remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+void ThreadPool::push(int slot, const Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(queues[slot]->mutex);
+        queues[slot]->tasks.push_back(task);
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    // Taking the lock orders this with a worker that is about to wait
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    wake.notify_one();
+}
+
+bool ThreadPool::pop(int slot, Task& task, const Loop* only) {
+    Queue& queue = *queues[slot];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty() || (only && queue.tasks.back().loop != only)) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::steal(int slot, Task& task, const Loop* only) {
+    const int count = threads();
+    for (int k = 1; k < count; ++k) {
+        Queue& victim = *queues[(slot + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        for (auto it = victim.tasks.begin(); it != victim.tasks.end(); ++it) {
+            if (only && it->loop != only) continue;
+            task = *it;
+            victim.tasks.erase(it);
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            queues[slot]->stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+PoolStats ThreadPool::stats() const {
+    PoolStats stats;
+    stats.threads = threads();
+    stats.parallel_loops = parallel_loops.load(std::memory_order_relaxed);
+    stats.inline_loops = inline_loops.load(std::memory_order_relaxed);
+    long long busy_ns = 0;
+    for (const auto& queue : queues) {
+        busy_ns += queue->busy_ns.load(std::memory_order_relaxed);
+        stats.tasks += queue->done.load(std::memory_order_relaxed);
+        stats.steals += queue->stolen.load(std::memory_order_relaxed);
+    }
+    stats.busy_seconds = busy_ns * 1e-9;
+    stats.wall_seconds = std::chrono::duration<double>(Clock::now() - created).count();
+    return stats;
+}
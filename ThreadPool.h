@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Settings.h"
+
+// Threads of the shared pool, including the thread that calls into it (POOL_THREADS, --threads);
+// 0 = one per hardware thread. Read when the pool is first used.
+extern int g_pool_threads;
+
+// What a pool did since it was created
+struct PoolStats {
+    int threads = 1;
+    long long parallel_loops = 0; // loops split over the pool
+    long long inline_loops = 0;   // loops too small to split, run on the calling thread
+    long long tasks = 0;          // pieces of the split loops that were run
+    long long steals = 0;         // of those, taken from another thread's queue
+    double busy_seconds = 0.0;    // all threads, running tasks
+    double wall_seconds = 0.0;
+    // Share of the pool's thread time spent running tasks
+    double utilization() const { return wall_seconds > 0.0 ? busy_seconds / (wall_seconds * threads) : 0.0; }
+};
+
+// Persistent work-stealing pool for the parallel loops of the simulation: the sensing queries of
+// a tick, offspring genomes, the gene pool's distance matrices, evaluation scenarios and saving.
+// parallel_for cuts [0, n) in halves on the thread that runs it: one half goes to the back of
+// that thread's queue, the other is cut again, down to the grain. Idle threads steal from the
+// front of the other queues, so they take the largest pieces left. A loop whose estimated work
+// is below two tasks' worth (POOL_MIN_TASK_WORK) runs inline, without waking anyone.
+// Loops may nest (a scenario on a worker runs its own ticks' loops); a thread that waits for a
+// loop only runs pieces of that loop, so a long unrelated task never lands on its stack.
+class ThreadPool {
+public:
+    // The process-wide pool, created on first use with g_pool_threads
+    static ThreadPool& shared();
+
+    explicit ThreadPool(int threads);
+    ~ThreadPool(); // finishes the queued tasks, then joins the workers
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int threads() const { return int(queues.size()); }
+
+    // Calls body(begin, end) over disjoint ranges covering [0, n) and returns when all are done.
+    // item_work is the estimated cost of one item in float ops, which picks the grain. The first
+    // exception thrown by body is rethrown here once the loop has finished.
+    template <typename F>
+    void parallel_for(size_t n, double item_work, F&& body) {
+        if (n == 0) return;
+        const double total = double(n) * std::max(item_work, 1.0);
+        if (threads() <= 1 || n < 2 || total < 2.0 * POOL_MIN_TASK_WORK) {
+            inline_loops.fetch_add(1, std::memory_order_relaxed);
+            body(size_t(0), n);
+            return;
+        }
+        // The fewest items worth a task; the loop is halved down to pieces of about that size
+        const size_t grain = std::max<size_t>(1, size_t(std::ceil(POOL_MIN_TASK_WORK / std::max(item_work, 1.0))));
+        using Body = std::remove_reference_t<F>;
+        run(n, grain, [](void* f, size_t begin, size_t end) { (*static_cast<Body*>(f))(begin, end); }, const_cast<void*>(static_cast<const void*>(&body)));
+    }
+
+    PoolStats stats() const;
+
+private:
+    struct Loop {
+        void (*invoke)(void*, size_t, size_t);
+        void* body;
+        size_t grain;
+        std::atomic<size_t> remaining; // items not finished yet
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+    struct Task {
+        Loop* loop;
+        size_t begin, end;
+    };
+    // One per thread; slot 0 belongs to the outside thread that currently drives the pool
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<long long> busy_ns{0}, done{0}, stolen{0};
+    };
+
+    void run(size_t n, size_t grain, void (*invoke)(void*, size_t, size_t), void* body);
+    void worker_loop(int slot);
+    void execute(int slot, Task task);
+    void push(int slot, const Task& task);
+    bool pop(int slot, Task& task, const Loop* only);
+    bool steal(int slot, Task& task, const Loop* only);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex outside_mutex;           // held by the outside thread using slot 0
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<long long> queued{0};   // tasks sitting in any queue
+    bool stopping = false;
+    std::atomic<long long> parallel_loops{0}, inline_loops{0};
+    std::chrono::steady_clock::time_point created;
+};
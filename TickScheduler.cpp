@@ -0,0 +1,37 @@
+#include "TickScheduler.h"
+#include "Settings.h"
+
+void TickScheduler::set_rate(double ticks_per_second, clock::time_point now) {
+    rate = ticks_per_second > 0.0 ? ticks_per_second : 0.0;
+    reset(now);
+}
+
+void TickScheduler::reset(clock::time_point now) {
+    start = now;
+    next = now;
+    last = now;
+    scheduled = 0;
+    window_start = now;
+    window_ticks = 0;
+    achieved = 0.0;
+}
+
+void TickScheduler::on_tick(clock::time_point now) {
+    last = now;
+    ++window_ticks;
+    auto window = now - window_start;
+    if (window >= std::chrono::milliseconds(SCHEDULER_RATE_WINDOW_MS)) {
+        achieved = window_ticks / std::chrono::duration<double>(window).count();
+        window_start = now;
+        window_ticks = 0;
+    }
+    if (unlimited()) return;
+    ++scheduled;
+    next = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(scheduled / rate));
+    if (now - next > std::chrono::milliseconds(SCHEDULER_MAX_BACKLOG_MS)) {
+        // Too far behind (a slow world at high speed): rebase instead of catching up in a burst
+        start = now;
+        next = now;
+        scheduled = 0;
+    }
+}
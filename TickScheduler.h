@@ -0,0 +1,34 @@
+#pragma once
+#include <chrono>
+
+// Fixed-timestep pacing for the simulation thread. Tick n after a reset is due at
+// start + n / rate, so the rate does not depend on how long ticks or frames take. A scheduler
+// that falls more than SCHEDULER_MAX_BACKLOG_MS behind drops the backlog instead of
+// spiralling; the achieved rate then shows the shortfall against the target.
+class TickScheduler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // ticks_per_second <= 0 runs unlimited (every tick is due at once)
+    void set_rate(double ticks_per_second, clock::time_point now);
+    // Starts counting from now, e.g. after a pause
+    void reset(clock::time_point now);
+    bool due(clock::time_point now) const { return unlimited() || now >= next; }
+    clock::time_point next_due() const { return next; }
+    // Records a tick that ran at now and schedules the next one
+    void on_tick(clock::time_point now);
+
+    bool unlimited() const { return rate <= 0.0; }
+    double target_rate() const { return rate; } // 0 = unlimited
+    // Ticks per second measured over the last completed window
+    double achieved_rate() const { return achieved; }
+    clock::time_point last_tick() const { return last; }
+
+private:
+    double rate = 0.0;
+    clock::time_point start{}, next{}, last{};
+    long long scheduled = 0; // ticks since start
+    clock::time_point window_start{};
+    long long window_ticks = 0;
+    double achieved = 0.0;
+};
@@ -0,0 +1,75 @@
+#include "Tunables.h"
+
+Tunables g_tunables;
+
+namespace {
+    // Name table: exactly one of the member pointers is set
+    struct TunableField {
+        const char* name;
+        float Tunables::* f;
+        int Tunables::* i;
+    };
+
+    const TunableField TUNABLE_FIELDS[] = {
+        {"GENE_POOL_SIZE", nullptr, &Tunables::gene_pool_size},
+        {"ELITISM_PERCENT", &Tunables::elitism_percent, nullptr},
+        {"MUTATION_RATE", &Tunables::mutation_rate, nullptr},
+        {"MUTATION_ATTEMPTS", nullptr, &Tunables::mutation_attempts},
+        {"MUTATION_MAGNITUDE", &Tunables::mutation_magnitude, nullptr},
+        {"LARGE_MUTATION_PROB", &Tunables::large_mutation_prob, nullptr},
+        {"LARGE_MUTATION_SCALE", &Tunables::large_mutation_scale, nullptr},
+        {"ADAPTIVE_MUTATION_PATIENCE", nullptr, &Tunables::adaptive_mutation_patience},
+        {"MAX_MUTATION_RATE", &Tunables::max_mutation_rate, nullptr},
+        {"ADAPTIVE_MUTATION_FACTOR", &Tunables::adaptive_mutation_factor, nullptr},
+        {"PRUNE_RATE", &Tunables::prune_rate, nullptr},
+        {"KILL_TIME", nullptr, &Tunables::kill_time},
+        {"HUNGER_BASE", &Tunables::hunger_base, nullptr},
+        {"HUNGER_SCALE", &Tunables::hunger_scale, nullptr},
+        {"HUNGER_EXPONENT", &Tunables::hunger_exponent, nullptr},
+        {"HUNGER_MIN", nullptr, &Tunables::hunger_min},
+        {"HUNGER_MAX", nullptr, &Tunables::hunger_max},
+        {"WALL_PENALTY_PER_FRAME", &Tunables::wall_penalty_per_frame, nullptr},
+        {"FITNESS_WEIGHT_FOOD", &Tunables::fitness_weight_food, nullptr},
+        {"FITNESS_WEIGHT_LIFE", &Tunables::fitness_weight_life, nullptr},
+        {"FITNESS_WEIGHT_EXPLORE", &Tunables::fitness_weight_explore, nullptr},
+        {"FITNESS_WEIGHT_PLAYERS", &Tunables::fitness_weight_players, nullptr},
+        {"FITNESS_WEIGHT_NOVELTY", &Tunables::fitness_weight_novelty, nullptr},
+        {"FITNESS_MIN_FOOD", &Tunables::fitness_min_food, nullptr},
+        {"FITNESS_MIN_LIFE", &Tunables::fitness_min_life, nullptr},
+        {"FITNESS_EARLY_DEATH_TIME", &Tunables::fitness_early_death_time, nullptr},
+        {"FITNESS_EARLY_DEATH_PENALTY", &Tunables::fitness_early_death_penalty, nullptr},
+        {"FITNESS_DIVERSITY_PRUNE_MIN_DIST", &Tunables::fitness_diversity_prune_min_dist, nullptr},
+        {"MIN_FITNESS_FOR_GENE_POOL", &Tunables::min_fitness_for_gene_pool, nullptr},
+        {"NUMBER_OF_FOODS", nullptr, &Tunables::number_of_foods},
+        {"HUNTERS", nullptr, &Tunables::hunters},
+        {"MIN_BOT", nullptr, &Tunables::min_bot},
+    };
+
+    const TunableField* find_field(const std::string& name) {
+        for (const auto& field : TUNABLE_FIELDS) {
+            if (name == field.name) return &field;
+        }
+        return nullptr;
+    }
+}
+
+bool Tunables::set(const std::string& name, double value) {
+    const TunableField* field = find_field(name);
+    if (!field) return false;
+    if (field->f) this->*(field->f) = float(value);
+    else this->*(field->i) = int(value);
+    return true;
+}
+
+bool Tunables::get(const std::string& name, double& value) const {
+    const TunableField* field = find_field(name);
+    if (!field) return false;
+    value = field->f ? double(this->*(field->f)) : double(this->*(field->i));
+    return true;
+}
+
+std::vector<std::string> Tunables::names() {
+    std::vector<std::string> result;
+    for (const auto& field : TUNABLE_FIELDS) result.push_back(field.name);
+    return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Settings.h"
+
+// Runtime copies of the Settings.h tuning values. The simulation reads these instead of
+// the constants so they can be varied without a recompile (e.g. by the parameter sweep).
+// Defaults are the Settings.h values; fields are addressed by their Settings.h names.
+struct Tunables {
+    // Genetic algorithm
+    int gene_pool_size = GENE_POOL_SIZE;
+    float elitism_percent = ELITISM_PERCENT;
+    float mutation_rate = MUTATION_RATE;
+    int mutation_attempts = MUTATION_ATTEMPTS;
+    float mutation_magnitude = MUTATION_MAGNITUDE;
+    float large_mutation_prob = LARGE_MUTATION_PROB;
+    float large_mutation_scale = LARGE_MUTATION_SCALE;
+    int adaptive_mutation_patience = ADAPTIVE_MUTATION_PATIENCE;
+    float max_mutation_rate = MAX_MUTATION_RATE;
+    float adaptive_mutation_factor = ADAPTIVE_MUTATION_FACTOR;
+    float prune_rate = PRUNE_RATE;
+    // Hunger
+    int kill_time = KILL_TIME;
+    float hunger_base = HUNGER_BASE;
+    float hunger_scale = HUNGER_SCALE;
+    float hunger_exponent = HUNGER_EXPONENT;
+    int hunger_min = HUNGER_MIN;
+    int hunger_max = HUNGER_MAX;
+    float wall_penalty_per_frame = WALL_PENALTY_PER_FRAME;
+    // Fitness
+    float fitness_weight_food = FITNESS_WEIGHT_FOOD;
+    float fitness_weight_life = FITNESS_WEIGHT_LIFE;
+    float fitness_weight_explore = FITNESS_WEIGHT_EXPLORE;
+    float fitness_weight_players = FITNESS_WEIGHT_PLAYERS;
+    float fitness_weight_novelty = FITNESS_WEIGHT_NOVELTY;
+    float fitness_min_food = FITNESS_MIN_FOOD;
+    float fitness_min_life = FITNESS_MIN_LIFE;
+    float fitness_early_death_time = FITNESS_EARLY_DEATH_TIME;
+    float fitness_early_death_penalty = FITNESS_EARLY_DEATH_PENALTY;
+    float fitness_diversity_prune_min_dist = FITNESS_DIVERSITY_PRUNE_MIN_DIST;
+    float min_fitness_for_gene_pool = MIN_FITNESS_FOR_GENE_POOL;
+    // World
+    int number_of_foods = NUMBER_OF_FOODS;
+    int hunters = HUNTERS;
+    int min_bot = MIN_BOT;
+
+    // Sets a field by its Settings.h name (e.g. "MUTATION_RATE"); false if unknown
+    bool set(const std::string& name, double value);
+    bool get(const std::string& name, double& value) const;
+    static std::vector<std::string> names();
+};
+
+extern Tunables g_tunables;
@@ -0,0 +1,492 @@
+// Microbenchmarks for the simulation hot paths.
+//
+// Usage: AI_Simulation_Bench [--filter SUBSTR] [--sizes 50,500,5000] [--min-time SECONDS]
+//                            [--format csv|jsonl] [--out FILE] [--baseline FILE] [--tolerance 0.15]
+//                            [--exact-math] [--verify-math]
+//
+// Every benchmark runs at each population size and reports nanoseconds per operation
+// (the median over timed batches). With --baseline, results are compared against a
+// previous --out file and the exit code is 1 if anything regressed by more than --tolerance.
+// --exact-math runs the simulation benchmarks with <cmath> instead of the FastMath.h
+// approximations; --verify-math only checks the approximations against their documented
+// error bounds (exit code 1 if one is exceeded).
+#include "Game.h"
+#include "Player.h"
+#include "Hunter.h"
+#include "Food.h"
+#include "Headless.h"
+#include "Tunables.h"
+#include "Snapshot.h"
+#include "Camera.h"
+#include "RenderBatch.h"
+#include "FastMath.h"
+#include "QuantizedNet.h"
+#include "Selection.h"
+#include "ThreadPool.h"
+#include "GenomeIndex.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchResult {
+        std::string name;
+        int population;
+        long long iterations; // operations measured
+        double ns_per_op;
+    };
+
+    struct BenchOptions {
+        std::string filter;
+        std::vector<int> sizes = {50, 500, 5000};
+        double min_time = 0.2;
+        std::string format = "csv";
+        std::string out;
+        std::string baseline;
+        double tolerance = 0.15;
+        bool verify_math = false;
+    };
+
+    BenchOptions options;
+    std::vector<BenchResult> results;
+
+    // Times body() in batches until min_time has passed. setup() runs before every batch
+    // and is not timed; body() performs ops_per_call operations.
+    void measure(const std::string& name, int population, long long ops_per_call, const std::function<void()>& setup, const std::function<void()>& body) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+        std::vector<double> samples;
+        long long iterations = 0;
+        double total = 0.0;
+        while (total < options.min_time || samples.size() < 3) {
+            if (setup) setup();
+            auto start = Clock::now();
+            body();
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            total += elapsed;
+            iterations += ops_per_call;
+            samples.push_back(elapsed * 1e9 / std::max(1LL, ops_per_call));
+            if (total > 10.0 * options.min_time && samples.size() >= 1) break; // very slow benchmarks
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        BenchResult result{name, population, iterations, samples[samples.size() / 2]};
+        results.push_back(result);
+        std::cerr << "  " << name << " n=" << population << ": " << result.ns_per_op << " ns/op" << std::endl;
+    }
+
+    // Fills the game with population bots and proportionally scaled food, in a world grown
+    // to keep the default density (MIN_BOT bots on one screen)
+    void make_world(Game& game, int population) {
+        HeadlessConfig config;
+        float scale = std::sqrt(std::max(1.0f, float(population) / MIN_BOT));
+        config.world_width = int(SCREEN_WIDTH * scale);
+        config.world_height = int(SCREEN_HEIGHT * scale);
+        config.bots = population;
+        config.foods = std::max(1, population * NUMBER_OF_FOODS / MIN_BOT);
+        config.hunters = HUNTERS;
+        config.seed = 1234;
+        populate_headless(game, config);
+        game.update_grids();
+    }
+
+    // Replaces the gene pool with n random entries of increasing fitness
+    void make_gene_pool(int n) {
+        Player::gene_pool.clear();
+        for (int i = 0; i < n; ++i) {
+            auto [genes, biases] = random_genes_and_biases();
+            Player::gene_pool.push_back({1000.0f + i, genes, biases});
+        }
+        std::sort(Player::gene_pool.begin(), Player::gene_pool.end(), [](const Player::GeneEntry& a, const Player::GeneEntry& b) { return a.fitness > b.fitness; });
+        Player::gene_pool_changed();
+    }
+
+    // Replaces the gene pool with n related entries: 20 random roots, then each entry a copy of
+    // an earlier one with a tenth of its weights nudged, as a pool fed by one lineage looks
+    void make_lineage_pool(int n) {
+        Player::gene_pool.clear();
+        for (int i = 0; i < n; ++i) {
+            Player::GeneEntry entry;
+            if (i < 20) {
+                auto [genes, biases] = random_genes_and_biases();
+                entry = {0.0f, genes, biases};
+            } else {
+                entry = Player::gene_pool[rand() % i];
+            }
+            for (auto& layer : entry.genes) {
+                for (auto& w : layer) {
+                    if (rand() % 10 == 0) w += ((float)rand() / RAND_MAX - 0.5f) * 0.3f;
+                }
+            }
+            entry.fitness = 1000.0f + i;
+            Player::gene_pool.push_back(entry);
+        }
+        std::sort(Player::gene_pool.begin(), Player::gene_pool.end(), [](const Player::GeneEntry& a, const Player::GeneEntry& b) { return a.fitness > b.fitness; });
+        Player::gene_pool_changed();
+    }
+
+    std::vector<Player*> bots_of(Game& game) {
+        std::vector<Player*> bots;
+        for (auto* p : game.players) {
+            if (std::find(game.hunters.begin(), game.hunters.end(), p) == game.hunters.end()) bots.push_back(p);
+        }
+        return bots;
+    }
+
+    void bench_world(int n) {
+        Game game(nullptr);
+        make_world(game, n);
+        std::vector<Player*> bots = bots_of(game);
+        std::array<float, NN_INPUTS> input{};
+        for (auto& v : input) v = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+        volatile float sink = 0.0f;
+
+        measure("predict", n, (long long)bots.size(), nullptr, [&]() {
+            for (auto* p : bots) sink = sink + p->predict(input)[0];
+        });
+        for (InferenceMode mode : {InferenceMode::Int8, InferenceMode::Float16}) {
+            for (auto* p : bots) p->qnet = QuantizedNet(p->genes, p->biases, mode);
+            measure(std::string("predict_") + inference_mode_name(mode), n, (long long)bots.size(), nullptr, [&]() {
+                for (auto* p : bots) sink = sink + p->predict(input)[0];
+            });
+        }
+        for (auto* p : bots) p->quantize_network();
+        for (auto* p : bots) p->compile_sparse_network();
+        measure("predict_sparse", n, (long long)bots.size(), nullptr, [&]() {
+            for (auto* p : bots) sink = sink + p->predict(input)[0];
+        });
+        for (auto* p : bots) p->sparse_net.reset();
+        measure("get_nn_inputs", n, (long long)bots.size(), nullptr, [&]() {
+            for (auto* p : bots) sink = sink + p->get_nn_inputs(game).inputs[0];
+        });
+        // Full queries, then the lazy path on a world that stands still (every answer reused)
+        game.sensors.lazy = false;
+        measure("sense_batch", n, (long long)game.players.size(), nullptr, [&]() {
+            game.sensors.sense(game);
+            sink = sink + (float)game.sensors.size();
+        });
+        game.sensors.lazy = true;
+        measure("sense_batch_lazy", n, (long long)game.players.size(), nullptr, [&]() {
+            game.sensors.sense(game);
+            sink = sink + (float)game.sensors.size();
+        });
+        game.sensors.lazy = LAZY_SENSING;
+        game.sensors.clear();
+        measure("update_grids", n, 1, nullptr, [&]() { game.update_grids(); });
+        measure("get_nearby_players", n, (long long)bots.size(), nullptr, [&]() {
+            for (auto* p : bots) sink = sink + (float)game.get_nearby_players(p->x, p->y).size();
+        });
+        measure("get_nearby_food", n, (long long)bots.size(), nullptr, [&]() {
+            for (auto* p : bots) sink = sink + (float)game.get_nearby_food(p->x, p->y).size();
+        });
+        measure("eatFood", n, (long long)bots.size(), [&]() { game.update_grids(); }, [&]() {
+            for (auto* p : bots) sink = sink + (float)p->eatFood(game);
+        });
+        measure("Hunter::update", n, (long long)std::max<size_t>(1, game.hunters.size()), [&]() {
+            game.update_grids();
+            for (auto* p : game.players) p->alive = true;
+            game.recount_population();
+        }, [&]() {
+            for (auto* h : game.hunters) h->update(game);
+        });
+        measure("collisions", n, (long long)game.players.size(), [&]() {
+            for (auto* p : game.players) p->alive = true;
+            game.recount_population();
+        }, [&]() {
+            game.collisions.resolve(game);
+            sink = sink + (float)game.collisions.candidates;
+        });
+        // What the simulation thread pays per published frame, then the UI's batch building
+        // (submission itself needs a real renderer)
+        RenderSnapshot snapshot;
+        measure("capture_snapshot", n, (long long)(game.players.size() + game.foods.size()), nullptr, [&]() {
+            capture_snapshot(game, snapshot);
+            sink = sink + (float)snapshot.entities.size();
+        });
+        Camera camera;
+        camera.fit_world(game.width, game.height);
+        RenderBatch batch;
+        measure("render_batch", n, (long long)snapshot.entities.size(), nullptr, [&]() {
+            draw_snapshot(snapshot, camera, batch);
+            sink = sink + (float)batch.rect_count();
+            batch.clear();
+        });
+        // Novelty scoring of the bots against an archive of their own descriptors over 400 ticks
+        // (about 20 per bot)
+        for (int tick = 0; tick < 400; ++tick) {
+            game.step_world();
+            if (tick % 4 == 0) {
+                for (auto* p : bots) game.novelty.record(game, *p);
+            }
+        }
+        measure("novelty_score", n, (long long)bots.size(), nullptr, [&]() {
+            game.novelty.score(game);
+            sink = sink + game.novelty.mean_novelty;
+        });
+        // Kill a tenth of the bots so every call has to refill the population
+        int refill = std::max(1, n / 10);
+        measure("maintain_population", n, 1, [&]() {
+            game.update_grids();
+            std::vector<Player*> current = bots_of(game);
+            for (int i = 0; i < refill && i < (int)current.size(); ++i) game.kill_player(*current[i]);
+        }, [&]() { game.maintain_population(); });
+    }
+
+    void bench_gene_pool(int n) {
+        g_tunables.gene_pool_size = n;
+        auto [genes, biases] = random_genes_and_biases();
+        float fitness = 1e6f;
+        measure("try_insert_gene_to_pool", n, 1, [&]() {
+            make_gene_pool(n);
+            fitness += 1.0f;
+        }, [&]() { Player::try_insert_gene_to_pool(fitness, genes, biases); });
+        measure("prune_gene_pool_diversity", n, 1, [&]() { make_gene_pool(n); }, [&]() {
+            Player::prune_gene_pool_diversity(g_tunables.fitness_diversity_prune_min_dist);
+        });
+        make_gene_pool(n);
+        volatile float sink = 0.0f;
+        // One shared-pool loop over n items of a genome's worth of float work; small n runs inline
+        ThreadPool& pool = ThreadPool::shared();
+        std::vector<float> item_sums(n, 0.0f);
+        measure("pool_parallel_for", n, n, nullptr, [&]() {
+            pool.parallel_for(size_t(n), 2.0 * NN_WEIGHT_COUNT, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const auto& layer = Player::gene_pool[i].genes[0];
+                    float sum = 0.0f;
+                    for (int r = 0; r < NN_WEIGHT_COUNT / int(layer.size()) + 1; ++r) {
+                        for (float w : layer) sum += w * w;
+                    }
+                    item_sums[i] = sum;
+                }
+            });
+            sink = sink + item_sums[0];
+        });
+        measure("genetic_distance", n, n, nullptr, [&]() {
+            for (int i = 0; i < n; ++i) sink = sink + Player::genetic_distance(Player::gene_pool[i], Player::gene_pool[(i + 1) % n]);
+        });
+        // Nearest other genome of every pool entry, through one index built per iteration, and
+        // by scanning every pair; on random genomes the index finds its tree useless and scans
+        GenomeIndex genome_index;
+        auto nearest_cases = [&](const std::string& suffix) {
+            measure("genome_index_nearest" + suffix, n, n, nullptr, [&]() {
+                genome_index.build(Player::gene_pool);
+                float dist = 0.0f;
+                for (int i = 0; i < n; ++i) sink = sink + float(genome_index.nearest(i, dist));
+            });
+            measure("genome_nearest_scan" + suffix, n, n, nullptr, [&]() {
+                for (int i = 0; i < n; ++i) {
+                    float best = 1e9f;
+                    for (int j = 0; j < n; ++j) {
+                        if (j != i) best = std::min(best, Player::genetic_distance(Player::gene_pool[i], Player::gene_pool[j]));
+                    }
+                    sink = sink + best;
+                }
+            });
+        };
+        nearest_cases("");
+        // The same on a pool of related genomes, where the index is meant to pay off
+        measure("prune_gene_pool_diversity_lineage", n, 1, [&]() { make_lineage_pool(n); }, [&]() {
+            Player::prune_gene_pool_diversity(g_tunables.fitness_diversity_prune_min_dist);
+        });
+        make_lineage_pool(n);
+        nearest_cases("_lineage");
+        make_gene_pool(n);
+        // Parent selection, per pair of parents; the tables are built once per pool version
+        ParentSampler sampler;
+        measure("sampler_sync", n, 1, [&]() { Player::gene_pool_changed(); }, [&]() {
+            sampler.sync(Player::gene_pool, Player::gene_pool_version);
+        });
+        for (SelectionMethod method : {SelectionMethod::Tournament, SelectionMethod::Proportional, SelectionMethod::Rank}) {
+            measure(std::string("select_") + selection_method_name(method), n, 1000, nullptr, [&]() {
+                for (int i = 0; i < 1000; ++i) sink = sink + (float)sampler.parents(method, 5).second;
+            });
+        }
+        const std::string file = "bench_gene_pool.tmp";
+        measure("save_gene_pool", n, 1, nullptr, [&]() { Player::save_gene_pool(file); });
+        measure("load_gene_pool", n, 1, nullptr, [&]() { Player::load_gene_pool(file); });
+        std::remove(file.c_str());
+        g_tunables.gene_pool_size = GENE_POOL_SIZE;
+    }
+
+    std::string format_result(const BenchResult& r) {
+        std::ostringstream oss;
+        if (options.format == "jsonl") {
+            oss << "{\"name\":\"" << r.name << "\",\"population\":" << r.population << ",\"iterations\":" << r.iterations << ",\"ns_per_op\":" << r.ns_per_op << "}";
+        } else {
+            oss << r.name << ',' << r.population << ',' << r.iterations << ',' << r.ns_per_op;
+        }
+        return oss.str();
+    }
+
+    // Reads a previous result file (csv or jsonl) into name/population -> ns_per_op
+    std::map<std::pair<std::string, int>, double> load_baseline(const std::string& path) {
+        std::map<std::pair<std::string, int>, double> baseline;
+        std::ifstream ifs(path);
+        std::string line;
+        while (std::getline(ifs, line)) {
+            if (line.empty() || line.rfind("name,", 0) == 0) continue;
+            std::string name;
+            int population = 0;
+            double ns = 0.0;
+            if (line[0] == '{') {
+                auto field = [&](const std::string& key) {
+                    size_t pos = line.find("\"" + key + "\":");
+                    return pos == std::string::npos ? std::string() : line.substr(pos + key.size() + 3);
+                };
+                std::string n = field("name");
+                name = n.substr(1, n.find('"', 1) - 1);
+                population = std::atoi(field("population").c_str());
+                ns = std::atof(field("ns_per_op").c_str());
+            } else {
+                std::istringstream iss(line);
+                std::string population_str, iterations_str, ns_str;
+                std::getline(iss, name, ',');
+                std::getline(iss, population_str, ',');
+                std::getline(iss, iterations_str, ',');
+                std::getline(iss, ns_str, ',');
+                population = std::atoi(population_str.c_str());
+                ns = std::atof(ns_str.c_str());
+            }
+            if (!name.empty()) baseline[{name, population}] = ns;
+        }
+        return baseline;
+    }
+
+    // Each function exact and approximated over 4096 inputs from its range in the tick
+    void bench_math() {
+        constexpr int N = 4096;
+        std::vector<float> a(N), b(N);
+        for (int i = 0; i < N; ++i) {
+            a[i] = ((float)rand() / RAND_MAX * 2.0f - 1.0f) * 500.0f;
+            b[i] = ((float)rand() / RAND_MAX * 2.0f - 1.0f) * 500.0f;
+        }
+        volatile float sink = 0.0f;
+        auto both = [&](const std::string& name, auto exact, auto fast) {
+            measure(name + "_exact", 0, N, nullptr, [&]() {
+                float sum = 0.0f;
+                for (int i = 0; i < N; ++i) sum += exact(a[i], b[i]);
+                sink = sink + sum;
+            });
+            measure(name + "_fast", 0, N, nullptr, [&]() {
+                float sum = 0.0f;
+                for (int i = 0; i < N; ++i) sum += fast(a[i], b[i]);
+                sink = sink + sum;
+            });
+        };
+        both("atan2", [](float y, float x) { return std::atan2(y, x); }, [](float y, float x) { return fast_atan2(y, x); });
+        both("exp", [](float x, float) { return std::exp(x * 0.01f); }, [](float x, float) { return fast_exp(x * 0.01f); });
+        both("tanh", [](float x, float) { return std::tanh(x * 0.01f); }, [](float x, float) { return fast_tanh(x * 0.01f); });
+        both("sincos", [](float x, float) { return std::sin(x * 0.01f) + std::cos(x * 0.01f); },
+             [](float x, float) { float s, c; fast_sincos(x * 0.01f, s, c); return s + c; });
+    }
+
+    // Largest error of every approximation against the double-precision function, over a dense
+    // sweep of its input range plus random points; returns the number of bounds exceeded
+    int verify_math() {
+        struct Check { const char* name; const char* range; double error; float bound; };
+        std::vector<Check> checks;
+        constexpr int STEPS = 2000000;
+        double atan2_error = 0.0;
+        for (int i = 0; i <= 2000; ++i) {
+            for (int j = 0; j <= 2000; ++j) {
+                for (float extent : {1.0f, 1000.0f}) {
+                    float y = extent * (i / 1000.0f - 1.0f), x = extent * (j / 1000.0f - 1.0f);
+                    atan2_error = std::max(atan2_error, std::fabs(fast_atan2(y, x) - std::atan2((double)y, (double)x)));
+                }
+            }
+        }
+        checks.push_back({"atan2", "x, y in [-1000, 1000]", atan2_error, FAST_ATAN2_MAX_ERROR});
+        double exp_error = 0.0, tanh_error = 0.0, sincos_error = 0.0;
+        for (int i = 0; i <= STEPS; ++i) {
+            float t = float(i) / STEPS;
+            float x = -80.0f + 160.0f * t;
+            double e = std::exp((double)x);
+            exp_error = std::max(exp_error, std::fabs(fast_exp(x) - e) / e);
+            float u = -20.0f + 40.0f * t;
+            tanh_error = std::max(tanh_error, std::fabs(fast_tanh(u) - std::tanh((double)u)));
+            float a = float(-4.0 * M_PI + 8.0 * M_PI * t);
+            float s, c;
+            fast_sincos(a, s, c);
+            sincos_error = std::max(sincos_error, std::max(std::fabs(s - std::sin((double)a)), std::fabs(c - std::cos((double)a))));
+        }
+        checks.push_back({"exp (relative)", "x in [-80, 80]", exp_error, FAST_EXP_MAX_REL_ERROR});
+        checks.push_back({"tanh", "x in [-20, 20]", tanh_error, FAST_TANH_MAX_ERROR});
+        checks.push_back({"sin/cos", "a in [-4pi, 4pi]", sincos_error, FAST_SINCOS_MAX_ERROR});
+        int failures = 0;
+        std::printf("%-16s %-24s %12s %12s\n", "function", "range", "max error", "bound");
+        for (const auto& check : checks) {
+            bool ok = check.error <= check.bound;
+            if (!ok) ++failures;
+            std::printf("%-16s %-24s %12.3g %12.3g %s\n", check.name, check.range, check.error, (double)check.bound, ok ? "ok" : "EXCEEDED");
+        }
+        return failures;
+    }
+
+    bool parse_args(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--exact-math") { g_fast_math = false; continue; }
+            if (arg == "--verify-math") { options.verify_math = true; continue; }
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            if (arg == "--filter") options.filter = value;
+            else if (arg == "--min-time") options.min_time = std::atof(value.c_str());
+            else if (arg == "--format") options.format = value;
+            else if (arg == "--out") options.out = value;
+            else if (arg == "--baseline") options.baseline = value;
+            else if (arg == "--tolerance") options.tolerance = std::atof(value.c_str());
+            else if (arg == "--sizes") {
+                options.sizes.clear();
+                std::istringstream iss(value);
+                std::string item;
+                while (std::getline(iss, item, ',')) options.sizes.push_back(std::atoi(item.c_str()));
+            } else return false;
+        }
+        return options.format == "csv" || options.format == "jsonl";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (!parse_args(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [--filter SUBSTR] [--sizes 50,500,5000] [--min-time S] [--format csv|jsonl] [--out FILE] [--baseline FILE] [--tolerance F] [--exact-math] [--verify-math]" << std::endl;
+        return 2;
+    }
+    if (options.verify_math) return verify_math() == 0 ? 0 : 1;
+    Player::hall_of_fame_file.clear();
+    Player::init_lookup_tables();
+    bench_math();
+    for (int n : options.sizes) {
+        std::cerr << "[bench] population " << n << std::endl;
+        bench_world(n);
+        bench_gene_pool(n);
+    }
+    std::ofstream file;
+    if (!options.out.empty()) file.open(options.out);
+    std::ostream& out = options.out.empty() ? std::cout : file;
+    if (options.format == "csv") out << "name,population,iterations,ns_per_op\n";
+    for (const auto& r : results) out << format_result(r) << '\n';
+
+    if (options.baseline.empty()) return 0;
+    auto baseline = load_baseline(options.baseline);
+    int regressions = 0;
+    std::cerr << "[bench] comparison against " << options.baseline << " (ratio = new / baseline)" << std::endl;
+    for (const auto& r : results) {
+        auto it = baseline.find({r.name, r.population});
+        if (it == baseline.end() || it->second <= 0.0) continue;
+        double ratio = r.ns_per_op / it->second;
+        bool regressed = ratio > 1.0 + options.tolerance;
+        if (regressed) ++regressions;
+        std::cerr << "  " << (regressed ? "REGRESSED " : "          ") << r.name << " n=" << r.population << ": " << ratio << "x" << std::endl;
+    }
+    return regressions == 0 ? 0 : 1;
+}
@@ -10,7 +10,25 @@
 #include <fstream>
 #include <map>
 #include "Settings.h"
+#include "Random.h"
 #include "GameApp.h"
+#include "Headless.h"
+#include "Island.h"
+#include "Sweep.h"
+#include "Evaluator.h"
+#include "FastMath.h"
+#include "QuantizedNet.h"
+#include "Selection.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "Tunables.h"
+#include <iostream>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <cmath>
 
 // Helper to render text
 void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
@@ -53,21 +71,17 @@ bool file_exists(const std::string& filename) {
 }
 
 // In main.cpp, declare a global variable for game time units:
-extern int game_time_units;
+extern thread_local int game_time_units;
 
 void restart_simulation(Game& game, SDL_Renderer* renderer, const std::vector<std::vector<std::vector<float>>>* loaded_genes = nullptr, const std::vector<std::vector<float>>* best_gene = nullptr) {
-    // Delete all players (which includes hunters)
-    for (auto* p : game.players) delete p;
-    for (auto* f : game.foods) delete f;
-    game.players.clear();
-    game.hunters.clear();
-    game.foods.clear();
+    // Delete all players (which includes hunters) and food
+    game.reset();
     // Ensure at least MIN_BOT bots
     g_bot_count = std::max(g_bot_count, MIN_BOT);
     int bots_to_spawn = g_bot_count;
     if (g_player_enabled) {
         // Add human player at center
-        game.players.push_back(new HumanPlayer(DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, SCREEN_WIDTH/2, SCREEN_HEIGHT/2));
+        game.add_player(new HumanPlayer(DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, SCREEN_WIDTH/2, SCREEN_HEIGHT/2));
         bots_to_spawn -= 1;
     }
     if (loaded_genes && !loaded_genes->empty()) {
@@ -75,26 +89,26 @@ void restart_simulation(Game& game, SDL_Renderer* renderer, const std::vector<st
         for (const auto& genes : *loaded_genes) {
             if (bots_to_spawn <= 0) break;
             auto [random_genes, random_biases] = random_genes_and_biases();
-            game.players.push_back(new Player(random_genes, random_biases, DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, static_cast<float>(rand() % SCREEN_WIDTH), static_cast<float>(rand() % SCREEN_HEIGHT)));
+            game.add_player(new Player(random_genes, random_biases, DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, static_cast<float>(sim_rand() % SCREEN_WIDTH), static_cast<float>(sim_rand() % SCREEN_HEIGHT)));
             used++;
             bots_to_spawn--;
         }
         if (used < bots_to_spawn) {
             for (int i = 0; i < bots_to_spawn - used; ++i) {
                 auto [genes, biases] = random_genes_and_biases();
-                SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
+                SDL_Color color = {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
                 game.newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
             }
         }
     } else if (best_gene && !best_gene->empty()) {
         for (int i = 0; i < bots_to_spawn; ++i) {
             auto [random_genes, random_biases] = random_genes_and_biases();
-            game.players.push_back(new Player(random_genes, random_biases, DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, static_cast<float>(rand() % SCREEN_WIDTH), static_cast<float>(rand() % SCREEN_HEIGHT)));
+            game.add_player(new Player(random_genes, random_biases, DOT_WIDTH, DOT_HEIGHT, DOT_COLOR, static_cast<float>(sim_rand() % SCREEN_WIDTH), static_cast<float>(sim_rand() % SCREEN_HEIGHT)));
         }
     } else {
         for (int i = 0; i < bots_to_spawn; ++i) {
             auto [genes, biases] = random_genes_and_biases();
-            SDL_Color color = {static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), static_cast<Uint8>(rand() % 256), 255};
+            SDL_Color color = {static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), static_cast<Uint8>(sim_rand() % 256), 255};
             game.newPlayer(genes, biases, DOT_WIDTH, DOT_HEIGHT, color, SPEED);
         }
     }
@@ -104,10 +118,271 @@ void restart_simulation(Game& game, SDL_Renderer* renderer, const std::vector<st
     game.randomFood(g_food_count);
 }
 
+// Options for the windowless modes
+struct CommandLine {
+    bool headless = false;
+    HeadlessConfig sim;
+    IslandConfig islands;
+    std::string sweep_spec;
+    SweepConfig sweep;
+    std::string replay_path; // play back a recording in the window
+    std::string evaluate;    // "pool" or "hof": score those genomes in seeded scenarios
+    std::string quant_report; // "pool" or "hof": compare those genomes' inference modes with fp32
+    bool lod_compare = false; // run the headless config with and without LOD scheduling
+    EvalConfig eval;
+};
+
+// Parses "WIDTHxHEIGHT" (e.g. 8192x8192)
+bool parse_world_size(const std::string& text, int& width, int& height) {
+    int w = 0, h = 0;
+    if (std::sscanf(text.c_str(), "%dx%d", &w, &h) != 2 || w < MAX_PLAYER_SIZE || h < MAX_PLAYER_SIZE) return false;
+    width = w;
+    height = h;
+    return true;
+}
+
+// Parses the headless command line options. Returns false on an unknown option.
+bool parse_headless_args(int argc, char* argv[], CommandLine& cli) {
+    cli.islands.islands = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        // The whole argument must be an integer in [low, high]
+        auto next_int = [&](long long& out, long long low, long long high) {
+            if (i + 1 >= argc) return false;
+            const char* text = argv[++i];
+            char* end = nullptr;
+            errno = 0;
+            out = std::strtoll(text, &end, 10);
+            return end != text && *end == '\0' && errno == 0 && out >= low && out <= high;
+        };
+        // The whole argument must be a finite number
+        auto next_float = [&](float& out) {
+            if (i + 1 >= argc) return false;
+            const char* text = argv[++i];
+            char* end = nullptr;
+            out = std::strtof(text, &end);
+            return end != text && *end == '\0' && std::isfinite(out);
+        };
+        auto next_str = [&](std::string& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        long long value = 0;
+        float real = 0.0f;
+        std::string text;
+        if (arg == "--headless") cli.headless = true;
+        else if (arg == "--islands" && next_int(value, 1, INT_MAX)) { cli.islands.islands = int(value); cli.headless = true; }
+        else if (arg == "--sweep" && next_str(cli.sweep_spec)) cli.headless = true;
+        else if (arg == "--ticks" && next_int(value, 1, LLONG_MAX)) cli.sim.ticks = value;
+        else if (arg == "--bots" && next_int(value, 1, INT_MAX)) cli.sim.bots = int(value);
+        else if (arg == "--foods" && next_int(value, 0, INT_MAX)) cli.sim.foods = int(value);
+        else if (arg == "--hunters" && next_int(value, 0, INT_MAX)) cli.sim.hunters = int(value);
+        else if (arg == "--seed" && next_int(value, 0, UINT_MAX)) cli.sim.seed = unsigned(value);
+        else if (arg == "--world" && next_str(text) && parse_world_size(text, cli.sim.world_width, cli.sim.world_height)) {}
+        else if (arg == "--migration-interval" && next_int(value, 0, INT_MAX)) cli.islands.migration_interval = int(value);
+        else if (arg == "--migrants" && next_int(value, 0, INT_MAX)) cli.islands.migrants = int(value);
+        else if (arg == "--pin") cli.islands.pin_cpus = true;
+        else if (arg == "--samples" && next_int(value, 0, INT_MAX)) cli.sweep.samples = int(value);
+        else if (arg == "--repeats" && next_int(value, 1, INT_MAX)) cli.sweep.repeats = int(value);
+        else if (arg == "--jobs" && next_int(value, 0, INT_MAX)) cli.sweep.jobs = int(value);
+        else if (arg == "--threshold" && next_float(real)) cli.sweep.fitness_threshold = real;
+        else if (arg == "--out" && next_str(cli.sweep.output)) {}
+        else if (arg == "--metrics" && next_str(cli.sim.metrics.path)) cli.sim.metrics.format = metrics_format_from_path(cli.sim.metrics.path);
+        else if (arg == "--metrics-interval" && next_int(value, 1, LLONG_MAX)) cli.sim.metrics.interval = value;
+        else if (arg == "--metrics-format" && next_str(text) && (text == "csv" || text == "jsonl")) cli.sim.metrics.format = text == "csv" ? MetricsFormat::Csv : MetricsFormat::Jsonl;
+        else if (arg == "--record" && next_str(cli.sim.record.path)) {}
+        else if (arg == "--record-interval" && next_int(value, 1, INT_MAX)) cli.sim.record.interval = int(value);
+        else if (arg == "--replay" && next_str(cli.replay_path)) {}
+        else if (arg == "--selection" && next_str(text) && parse_selection_method(text, g_selection)) {}
+        else if (arg == "--lod" && next_int(value, 1, INT_MAX)) cli.sim.lod_interval = int(value);
+        else if (arg == "--lod-compare") cli.lod_compare = true;
+        else if (arg == "--threads" && next_int(value, 1, INT_MAX)) g_pool_threads = int(value);
+        else if (arg == "--novelty" && next_float(real) && real >= 0.0f) g_tunables.fitness_weight_novelty = real;
+        else if (arg == "--exact-math") g_fast_math = false;
+        else if (arg == "--inference" && next_str(text) && parse_inference_mode(text, g_inference_mode)) {}
+        else if (arg == "--quant-report" && next_str(cli.quant_report) && (cli.quant_report == "pool" || cli.quant_report == "hof")) {}
+        else if (arg == "--evaluate" && next_str(cli.evaluate) && (cli.evaluate == "pool" || cli.evaluate == "hof")) {}
+        else if (arg == "--eval-scenarios" && next_int(value, 1, INT_MAX)) cli.eval.scenarios = int(value);
+        else if (arg == "--eval-ticks" && next_int(value, 1, INT_MAX)) cli.eval.ticks = int(value);
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    cli.islands.sim = cli.sim;
+    cli.sweep.sim = cli.sim;
+    if (cli.sim.seed != 0) cli.eval.seed = cli.sim.seed;
+    cli.eval.threads = cli.sweep.jobs;
+    return true;
+}
+
+// The saved gene pool ("pool") or hall of fame ("hof"); null, with a message, when it is empty
+const std::vector<Player::GeneEntry>* load_genomes(const std::string& source) {
+    const std::string file = source == "hof" ? "hall_of_fame.txt" : "gene_pool.txt";
+    if (source == "hof") Player::load_hall_of_fame(file);
+    else Player::load_gene_pool(file);
+    const auto& genomes = source == "hof" ? Player::hall_of_fame : Player::gene_pool;
+    if (genomes.empty()) {
+        std::cerr << "No genomes to evaluate in " << file << std::endl;
+        return nullptr;
+    }
+    return &genomes;
+}
+
+// Scores the saved gene pool or hall of fame in the evaluation scenarios and prints a table
+int run_evaluation(const CommandLine& cli) {
+    const auto* loaded = load_genomes(cli.evaluate);
+    if (!loaded) return 1;
+    const auto& genomes = *loaded;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<EvalResult> results = evaluate_genomes(genomes, cli.eval);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long ticks = 0;
+    std::printf("%5s %12s %12s %12s %10s\n", "#", "stored", "mean", "stddev", "ticks");
+    for (size_t i = 0; i < results.size(); ++i) {
+        ticks += results[i].ticks;
+        std::printf("%5zu %12.1f %12.1f %12.1f %10lld\n", i, genomes[i].fitness, results[i].mean, std::sqrt(results[i].variance), results[i].ticks);
+    }
+    std::cout << genomes.size() << " genomes x " << cli.eval.scenarios << " scenarios (seed " << cli.eval.seed << ") in " << seconds
+              << " s, " << (seconds > 0.0 ? ticks / seconds : 0.0) << " ticks/s" << std::endl;
+    return 0;
+}
+
+// Compares the int8 and fp16 inference modes with fp32 on the saved gene pool or hall of fame
+int run_quant_report(const CommandLine& cli) {
+    const auto* genomes = load_genomes(cli.quant_report);
+    if (!genomes) return 1;
+    std::vector<DivergenceReport> reports = measure_inference_divergence(*genomes, cli.eval);
+    std::printf("%-5s %8s %8s %10s %10s %10s %10s %10s %10s %8s\n", "mode", "bytes", "ns/net", "angle avg", "angle max",
+                "speed avg", "speed max", "fitness", "|dfit|", "rank r");
+    for (const auto& r : reports) {
+        std::printf("%-5s %8zu %8.1f %10.5f %10.5f %10.5f %10.5f %10.1f %10.1f %8.3f\n", inference_mode_name(r.mode), r.weight_bytes,
+                    r.ns_per_forward, r.mean_angle_error, r.max_angle_error, r.mean_speed_error, r.max_speed_error,
+                    r.mean_fitness, r.mean_fitness_change, r.rank_correlation);
+    }
+    std::cout << genomes->size() << " genomes x " << cli.eval.scenarios << " scenarios (seed " << cli.eval.seed
+              << "); angle in radians, speed in units per tick" << std::endl;
+    return 0;
+}
+
+// Runs the same seeded headless world at full rate and with LOD scheduling, both starting from
+// the saved gene pool, and prints their fitness trajectories side by side
+int run_lod_compare(const CommandLine& cli) {
+    Player::load_gene_pool("gene_pool.txt");
+    const std::vector<Player::GeneEntry> pool = Player::gene_pool;
+    const long long every = cli.sim.metrics.interval > 0 ? cli.sim.metrics.interval : METRICS_INTERVAL;
+    const int interval = cli.sim.lod_interval > 1 ? cli.sim.lod_interval : LOD_INTERVAL;
+    // The runs must not overwrite the saved hall of fame; it is restored afterwards
+    const std::vector<Player::GeneEntry> hall_of_fame = Player::hall_of_fame;
+    const std::string hall_of_fame_file = Player::hall_of_fame_file;
+    Player::hall_of_fame_file.clear();
+    struct Trajectory {
+        std::vector<std::pair<float, float>> fitness; // gene pool best, mean of the alive bots; every `every` ticks
+        HeadlessResult result;
+        float reduced = 0.0f;
+    };
+    auto run = [&](int lod_interval) {
+        Player::gene_pool = pool;
+        Player::gene_pool_changed();
+        Player::hall_of_fame.clear();
+        Player::adaptive_mutation_rate = g_tunables.mutation_rate;
+        // Fresh uids too: they stagger the LOD updates
+        Player::reset_uids();
+        Food::reset_uids();
+        game_time_units = 0;
+        HeadlessConfig config = cli.sim;
+        config.lod_interval = lod_interval;
+        config.seed = cli.sim.seed != 0 ? cli.sim.seed : 1;
+        config.metrics.path.clear();
+        config.record.path.clear();
+        Trajectory trajectory;
+        Game game(nullptr);
+        populate_headless(game, config);
+        trajectory.result = run_headless(game, config, [&](Game&, long long tick) {
+            if (tick % every != 0) return true;
+            float total = 0.0f;
+            int alive = 0;
+            for (const auto* p : game.players) {
+                if (p && p->alive && !p->is_human) { total += Game::calc_fitness(p); ++alive; }
+            }
+            float best = Player::gene_pool.empty() ? 0.0f : Player::gene_pool.front().fitness;
+            trajectory.fitness.push_back({best, alive > 0 ? total / alive : 0.0f});
+            return true;
+        });
+        trajectory.reduced = game.lod.reduced_fraction();
+        return trajectory;
+    };
+    Trajectory full = run(1);
+    Trajectory lod = run(interval);
+    Player::hall_of_fame = hall_of_fame;
+    Player::hall_of_fame_file = hall_of_fame_file;
+    std::printf("%10s %12s %12s %12s %12s\n", "tick", "pool best", "alive avg", "best (lod)", "avg (lod)");
+    for (size_t i = 0; i < std::min(full.fitness.size(), lod.fitness.size()); ++i) {
+        std::printf("%10lld %12.1f %12.1f %12.1f %12.1f\n", (long long)(i + 1) * every, full.fitness[i].first, full.fitness[i].second,
+                    lod.fitness[i].first, lod.fitness[i].second);
+    }
+    std::printf("full rate: %.0f ticks/s; lod every %d ticks beyond %.0f: %.0f ticks/s, %.1f%% of bot updates at the reduced rate\n",
+                full.result.ticks_per_second, interval, LOD_RADIUS, lod.result.ticks_per_second, lod.reduced * 100.0f);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    CommandLine cli;
+    if (!parse_headless_args(argc, argv, cli)) {
+        std::cerr << "Usage: " << argv[0] << " [--headless] [--islands N] [--ticks N] [--bots N] [--foods N] [--hunters N] [--seed N] [--world WxH]"
+                  << " [--migration-interval N] [--migrants N] [--pin]"
+                  << " [--sweep SPEC] [--samples N] [--repeats N] [--jobs N] [--threshold F] [--out FILE]"
+                  << " [--metrics FILE] [--metrics-interval N] [--metrics-format csv|jsonl]"
+                  << " [--record FILE] [--record-interval N] [--replay FILE]"
+                  << " [--evaluate pool|hof] [--eval-scenarios N] [--eval-ticks N] [--exact-math]"
+                  << " [--inference fp32|int8|fp16] [--quant-report pool|hof] [--lod K] [--lod-compare] [--threads N] [--novelty W]"
+                  << " [--selection tournament|proportional|rank]" << std::endl;
+        return 1;
+    }
+    if (!cli.evaluate.empty()) return run_evaluation(cli);
+    if (!cli.quant_report.empty()) return run_quant_report(cli);
+    if (cli.lod_compare) return run_lod_compare(cli);
+    if (!cli.sweep_spec.empty()) {
+        if (!load_sweep_spec(cli.sweep_spec, cli.sweep)) return 1;
+        return run_sweep(cli.sweep) == 0 ? 0 : 1;
+    }
+    if (cli.headless) {
+        Player::load_gene_pool("gene_pool.txt");
+        int failed = 0;
+        if (cli.islands.islands > 0) {
+            failed = run_islands(cli.islands);
+        } else {
+            Game game(nullptr);
+            populate_headless(game, cli.sim);
+            HeadlessResult result = run_headless(game, cli.sim);
+            std::cout << "ticks: " << result.ticks << ", ticks/s: " << result.ticks_per_second << ", best fitness: " << result.best_fitness << std::endl;
+            if (TickProfiler::enabled()) {
+                std::cout << "phase (last " << TickProfiler::samples() << " ticks)   p50 us   p99 us" << std::endl;
+                for (int i = 0; i < TickProfiler::PHASES; ++i) {
+                    ProfilePhase phase = static_cast<ProfilePhase>(i);
+                    std::printf("%-20s %8.1f %8.1f\n", TickProfiler::phase_name(phase),
+                                TickProfiler::percentile_us(phase, 0.5f), TickProfiler::percentile_us(phase, 0.99f));
+                }
+            }
+            if (NoveltySearch::enabled()) {
+                const NoveltySearch& novelty = game.novelty;
+                std::printf("novelty: %zu archived of %lld offered, %lld scorings, %.1f ms each, last mean %.3f\n",
+                            novelty.archived(), novelty.offered, novelty.scorings,
+                            novelty.scorings > 0 ? 1000.0 * novelty.seconds / novelty.scorings : 0.0, novelty.mean_novelty);
+            }
+            const PoolStats pool = ThreadPool::shared().stats();
+            std::printf("thread pool: %d threads, %.1f%% busy, %lld parallel / %lld inline loops, %lld tasks, %lld stolen\n",
+                        pool.threads, 100.0 * pool.utilization(), pool.parallel_loops, pool.inline_loops, pool.tasks, pool.steals);
+        }
+        Player::save_gene_pool("gene_pool.txt");
+        return failed == 0 ? 0 : 1;
+    }
     GameApp app;
+    app.set_world_size(cli.sim.world_width, cli.sim.world_height);
+    if (!cli.replay_path.empty()) app.set_replay(cli.replay_path);
     if (!app.init()) return 1;
     app.run();
     app.cleanup();
     return 0;
-} 
\ No newline at end of file
+}
\ No newline at end of file